@@ -0,0 +1,112 @@
+#include "ArrayDecoding.h"
+#include "Base64.h"
+
+namespace {
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        char x = a[i], y = b[i];
+        if (x >= 'A' && x <= 'Z') x = static_cast<char>(x - 'A' + 'a');
+        if (y >= 'A' && y <= 'Z') y = static_cast<char>(y - 'A' + 'a');
+        if (x != y) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+ValueType valueTypeFromXML(std::string_view name) {
+    if (name == "Float32") return ValueType::Float32;
+    if (name == "Float64") return ValueType::Float64;
+    if (name == "Int32") return ValueType::Int32;
+    if (name == "UInt32") return ValueType::UInt32;
+    if (name == "Int64") return ValueType::Int64;
+    if (name == "UInt64") return ValueType::UInt64;
+    if (name == "Int16") return ValueType::Int16;
+    if (name == "UInt16") return ValueType::UInt16;
+    if (name == "Int8") return ValueType::Int8;
+    if (name == "UInt8") return ValueType::UInt8;
+    return ValueType::Unknown;
+}
+
+ValueType valueTypeFromLegacy(std::string_view name) {
+    if (equalsIgnoreCase(name, "float")) return ValueType::Float32;
+    if (equalsIgnoreCase(name, "double")) return ValueType::Float64;
+    if (equalsIgnoreCase(name, "int")) return ValueType::Int32;
+    if (equalsIgnoreCase(name, "unsigned_int")) return ValueType::UInt32;
+    if (equalsIgnoreCase(name, "vtktypeint64")) return ValueType::Int64;
+    if (equalsIgnoreCase(name, "vtktypeuint64")) return ValueType::UInt64;
+    if (equalsIgnoreCase(name, "short")) return ValueType::Int16;
+    if (equalsIgnoreCase(name, "unsigned_short")) return ValueType::UInt16;
+    if (equalsIgnoreCase(name, "char")) return ValueType::Int8;
+    if (equalsIgnoreCase(name, "unsigned_char") || equalsIgnoreCase(name, "bit")) return ValueType::UInt8;
+    return ValueType::Unknown;
+}
+
+size_t valueTypeSize(ValueType type) {
+    switch (type) {
+        case ValueType::Int8: case ValueType::UInt8: return 1;
+        case ValueType::Int16: case ValueType::UInt16: return 2;
+        case ValueType::Int32: case ValueType::UInt32: case ValueType::Float32: return 4;
+        case ValueType::Int64: case ValueType::UInt64: case ValueType::Float64: return 8;
+        default: return 0;
+    }
+}
+
+const char* findNumericBlockEnd(const char* begin, const char* end) {
+    const char* cur = begin;
+    while (cur < end) {
+        const char* lineStart = cur;
+        while (lineStart < end && (*lineStart == ' ' || *lineStart == '\t' || *lineStart == '\r')) lineStart++;
+        if (lineStart < end) {
+            char c = *lineStart;
+            if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) return cur;
+        }
+        
+        const char* newline = static_cast<const char*>(std::memchr(lineStart, '\n', static_cast<size_t>(end - lineStart)));
+        if (!newline) return end;
+        cur = newline + 1;
+    }
+    return end;
+}
+
+uint64_t readBlockHeader(const uint8_t* bytes, size_t size, bool bigEndian) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; i++) {
+        size_t shift = bigEndian ? (size - 1 - i) * 8 : i * 8;
+        value |= static_cast<uint64_t>(bytes[i]) << shift;
+    }
+    return value;
+}
+
+bool decodeBase64Block(const char* text, size_t length, size_t headerSize, bool bigEndian,
+                       size_t expectedBytes, std::vector<uint8_t>& scratch, const char*& data) {
+    while (length > 0 && (*text == ' ' || *text == '\n' || *text == '\r' || *text == '\t')) {
+        text++;
+        length--;
+    }
+    
+    size_t headerChars = (headerSize + 2) / 3 * 4;
+    if (headerSize == 0 || headerSize > 8 || length < headerChars) return false;
+    
+    uint8_t header[8];
+    bool separate = std::string_view(text, headerChars).find('=') != std::string_view::npos;
+    scratch.resize(headerSize + expectedBytes + 32);      // folga para o decodificador AVX2
+    
+    if (separate) {
+        if (decodeBase64(text, headerChars, header, headerSize) != headerSize) return false;
+        uint64_t byteCount = readBlockHeader(header, headerSize, bigEndian);
+        if (byteCount < expectedBytes) return false;
+        size_t written = decodeBase64(text + headerChars, length - headerChars, scratch.data(), expectedBytes + 32);
+        if (written < expectedBytes) return false;
+        data = reinterpret_cast<const char*>(scratch.data());
+    } else {
+        size_t written = decodeBase64(text, length, scratch.data(), scratch.size());
+        if (written < headerSize + expectedBytes) return false;
+        uint64_t byteCount = readBlockHeader(scratch.data(), headerSize, bigEndian);
+        if (byteCount < expectedBytes) return false;
+        data = reinterpret_cast<const char*>(scratch.data()) + headerSize;
+    }
+    return true;
+}
@@ -0,0 +1,208 @@
+#ifndef ARRAYDECODING_H
+#define ARRAYDECODING_H
+
+#include "ByteSwap.h"
+#include "ParallelFor.h"
+#include <vector>
+#include <string_view>
+#include <charconv>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+// Leitura dos arrays numéricos dos formatos VTK (legado e XML), compartilhada
+// pelos leitores e pela tabela de atributos
+
+enum class ValueType : uint8_t {
+    Unknown, Int8, UInt8, Int16, UInt16, Int32, UInt32, Int64, UInt64, Float32, Float64
+};
+
+ValueType valueTypeFromXML(std::string_view name);       // "Float32", "Int64"...
+ValueType valueTypeFromLegacy(std::string_view name);    // "float", "double", "int"...
+size_t valueTypeSize(ValueType type);
+
+// Onde estão os valores de um array no arquivo de origem e como estão gravados
+struct ArraySource {
+    enum Encoding : uint8_t { Text, Binary, Base64 };
+    Encoding encoding = Text;
+    ValueType type = ValueType::Float32;
+    uint8_t headerSize = 0;     // Base64: bytes do cabeçalho com o tamanho (VTK XML)
+    bool bigEndian = false;
+    uint64_t begin = 0;         // intervalo de bytes no arquivo
+    uint64_t end = 0;
+    uint64_t count = 0;         // número de valores
+};
+
+// Arquivos ASCII acima deste tamanho têm os blocos numéricos lidos em paralelo
+const size_t parallelParseThreshold = 8 * 1024 * 1024;
+
+// Fim de um bloco numérico ASCII: início da primeira linha que começa com
+// letra (a próxima palavra-chave) ou o fim do arquivo
+const char* findNumericBlockEnd(const char* begin, const char* end);
+
+uint64_t readBlockHeader(const uint8_t* bytes, size_t size, bool bigEndian);
+
+// Decodifica um bloco base64 do VTK XML (cabeçalho com o tamanho + dados) em
+// scratch; data aponta para o início dos valores. O VTK codifica cabeçalho e
+// dados separadamente, cada um com seu '=' final; outros gravadores codificam
+// tudo junto. Os dois casos são aceitos.
+bool decodeBase64Block(const char* text, size_t length, size_t headerSize, bool bigEndian,
+                       size_t expectedBytes, std::vector<uint8_t>& scratch, const char*& data);
+
+// Converte count valores do tipo Source (na ordem de bytes do arquivo) para T
+template <typename Source, typename T>
+void convertValues(const char* bytes, size_t count, bool bigEndian, T* out) {
+    Source buffer[1024];
+    for (size_t done = 0; done < count; ) {
+        size_t n = std::min(count - done, sizeof(buffer) / sizeof(buffer[0]));
+        const char* source = bytes + done * sizeof(Source);
+        if (bigEndian && sizeof(Source) == 4) {
+            copyBigEndian32(source, n, buffer);
+        } else if (bigEndian && sizeof(Source) == 8) {
+            copyBigEndian64(source, n, buffer);
+        } else {
+            std::memcpy(buffer, source, n * sizeof(Source));
+            if (bigEndian && sizeof(Source) == 2) {
+                for (size_t i = 0; i < n; i++) {
+                    uint16_t word;
+                    std::memcpy(&word, &buffer[i], 2);
+                    word = static_cast<uint16_t>((word >> 8) | (word << 8));
+                    std::memcpy(&buffer[i], &word, 2);
+                }
+            }
+        }
+        for (size_t i = 0; i < n; i++) out[done + i] = static_cast<T>(buffer[i]);
+        done += n;
+    }
+}
+
+template <typename T>
+bool convertBinary(ValueType type, const char* bytes, size_t count, bool bigEndian, T* out) {
+    switch (type) {
+        case ValueType::Float32: convertValues<float>(bytes, count, bigEndian, out); return true;
+        case ValueType::Float64: convertValues<double>(bytes, count, bigEndian, out); return true;
+        case ValueType::Int32: convertValues<int32_t>(bytes, count, bigEndian, out); return true;
+        case ValueType::UInt32: convertValues<uint32_t>(bytes, count, bigEndian, out); return true;
+        case ValueType::Int64: convertValues<int64_t>(bytes, count, bigEndian, out); return true;
+        case ValueType::UInt64: convertValues<uint64_t>(bytes, count, bigEndian, out); return true;
+        case ValueType::Int16: convertValues<int16_t>(bytes, count, bigEndian, out); return true;
+        case ValueType::UInt16: convertValues<uint16_t>(bytes, count, bigEndian, out); return true;
+        case ValueType::Int8: convertValues<int8_t>(bytes, count, bigEndian, out); return true;
+        case ValueType::UInt8: convertValues<uint8_t>(bytes, count, bigEndian, out); return true;
+        default: return false;
+    }
+}
+
+// Lê um número de texto; inteiros gravados como reais ("3.0") e vice-versa são aceitos
+template <typename T>
+bool parseTextValue(const char*& cur, const char* end, T& value) {
+    while (cur < end && (*cur == ' ' || *cur == '\n' || *cur == '\r' || *cur == '\t')) cur++;
+    auto result = std::from_chars(cur, end, value);
+    if (result.ec != std::errc()) {
+        double real;
+        result = std::from_chars(cur, end, real);
+        if (result.ec != std::errc()) return false;
+        value = static_cast<T>(real);
+    }
+    cur = result.ptr;
+    return true;
+}
+
+// Lê os números de [begin, end) em paralelo. O bloco é dividido em trechos
+// terminados em fim de linha; cada thread conta os valores do seu trecho, para
+// saber a partir de que índice escreve, e depois os lê. prepare(total) aloca o
+// destino (false se o total não servir) e store(índice, valor) grava cada valor.
+template <typename T, typename Prepare, typename Store>
+bool parseTextParallel(const char* begin, const char* end, unsigned int threadCount, Prepare prepare, Store store) {
+    size_t chunkCount = threadCount * 4;
+    size_t chunkBytes = std::max<size_t>(static_cast<size_t>(end - begin) / chunkCount, 1);
+    
+    std::vector<const char*> bounds(1, begin);
+    while (bounds.back() < end) {
+        const char* cut = bounds.back() + std::min(chunkBytes, static_cast<size_t>(end - bounds.back()));
+        const char* newline = static_cast<const char*>(std::memchr(cut, '\n', static_cast<size_t>(end - cut)));
+        bounds.push_back(newline ? newline + 1 : end);
+    }
+    chunkCount = bounds.size() - 1;
+    
+    // Conta os inícios de valor (branco seguido de não branco); cada trecho
+    // começa em início de linha. Se a contagem não bater com a leitura, a
+    // função falha e quem chamou volta para a leitura sequencial.
+    std::vector<size_t> firstIndex(chunkCount + 1, 0);
+    parallelFor(threadCount, chunkCount, [&](size_t chunk) {
+        const unsigned char* c = reinterpret_cast<const unsigned char*>(bounds[chunk]);
+        size_t length = static_cast<size_t>(bounds[chunk + 1] - bounds[chunk]);
+        size_t tokens = (length > 0 && c[0] > ' ') ? 1 : 0;
+        for (size_t i = 1; i < length; i++) {
+            tokens += (c[i - 1] <= ' ') & (c[i] > ' ');
+        }
+        firstIndex[chunk + 1] = tokens;
+    });
+    for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+        firstIndex[chunk + 1] += firstIndex[chunk];
+    }
+    if (!prepare(firstIndex[chunkCount])) return false;
+    
+    std::atomic<bool> valid(true);
+    parallelFor(threadCount, chunkCount, [&](size_t chunk) {
+        const char* cur = bounds[chunk];
+        const char* chunkEnd = bounds[chunk + 1];
+        for (size_t i = firstIndex[chunk]; i < firstIndex[chunk + 1]; i++) {
+            T value;
+            if (!parseTextValue(cur, chunkEnd, value)) {
+                valid = false;
+                return;
+            }
+            store(i, value);
+        }
+        while (cur < chunkEnd && static_cast<unsigned char>(*cur) <= ' ') cur++;
+        if (cur != chunkEnd) valid = false;     // sobrou texto que não é número
+    });
+    return valid;
+}
+
+// Lê os source.count valores de um array do arquivo mapeado [file, file + size)
+template <typename T>
+bool readArraySource(const char* file, size_t size, const ArraySource& source, T* out) {
+    if (source.begin > source.end || source.end > size) return false;
+    const char* begin = file + source.begin;
+    const char* end = file + source.end;
+    size_t count = static_cast<size_t>(source.count);
+    
+    if (source.encoding == ArraySource::Text) {
+        unsigned int threadCount = std::thread::hardware_concurrency();
+        if (static_cast<size_t>(end - begin) >= parallelParseThreshold && threadCount > 1) {
+            bool parsed = parseTextParallel<T>(begin, end, threadCount,
+                [count](size_t total) { return total == count; },
+                [out](size_t index, T value) { out[index] = value; });
+            if (parsed) return true;
+        }
+        
+        const char* cur = begin;
+        for (size_t i = 0; i < count; i++) {
+            if (!parseTextValue(cur, end, out[i])) return false;
+        }
+        return true;
+    }
+    
+    size_t expectedBytes = count * valueTypeSize(source.type);
+    if (expectedBytes == 0 && count > 0) return false;
+    
+    if (source.encoding == ArraySource::Binary) {
+        if (static_cast<size_t>(end - begin) < expectedBytes) return false;
+        return convertBinary(source.type, begin, count, source.bigEndian, out);
+    }
+    
+    std::vector<uint8_t> scratch;
+    const char* data = nullptr;
+    if (!decodeBase64Block(begin, static_cast<size_t>(end - begin), source.headerSize, source.bigEndian,
+                           expectedBytes, scratch, data)) {
+        return false;
+    }
+    return convertBinary(source.type, data, count, source.bigEndian, out);
+}
+
+#endif
@@ -0,0 +1,138 @@
+#include "AsyncTreeLoader.h"
+#include <iostream>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+AsyncTreeLoader::AsyncTreeLoader()
+    : running(false), hasRequest(false), loading(false), hasReady(false),
+      cache(defaultCacheBudget) {}
+
+AsyncTreeLoader::~AsyncTreeLoader() {
+    stop();
+}
+
+void AsyncTreeLoader::start() {
+    if (running) return;
+    running = true;
+    worker = std::thread(&AsyncTreeLoader::workerLoop, this);
+}
+
+void AsyncTreeLoader::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+    }
+    wake.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+void AsyncTreeLoader::request(const std::vector<std::string>& files, size_t index) {
+    if (index >= files.size()) return;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        hasRequest = true;
+        requestedPath = files[index];
+        
+        // Anterior e próximo, com a mesma volta circular da navegação
+        neighborPaths.clear();
+        if (files.size() > 1) {
+            neighborPaths.push_back(files[(index + 1) % files.size()]);
+            neighborPaths.push_back(files[(index + files.size() - 1) % files.size()]);
+        }
+    }
+    wake.notify_one();
+}
+
+bool AsyncTreeLoader::takeReady(LoadedTree& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!hasReady) return false;
+    
+    result = std::move(ready);
+    ready = LoadedTree();
+    hasReady = false;
+    return true;
+}
+
+bool AsyncTreeLoader::isLoading() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hasRequest || loading;
+}
+
+void AsyncTreeLoader::setCacheBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    cache.setBudget(bytes);
+}
+
+CacheStats AsyncTreeLoader::getCacheStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cache.getStats();
+}
+
+std::string AsyncTreeLoader::cacheKey(const std::string& path) {
+    std::error_code error;
+    auto modified = fs::last_write_time(path, error);
+    long long stamp = error ? 0 : static_cast<long long>(modified.time_since_epoch().count());
+    return path + "@" + std::to_string(stamp);
+}
+
+std::shared_ptr<const TreeModel> AsyncTreeLoader::loadTree(const std::string& path) {
+    return loadTreeModel(path);
+}
+
+void AsyncTreeLoader::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    
+    while (running) {
+        wake.wait(lock, [this]() { return !running || hasRequest; });
+        if (!running) break;
+        
+        std::string path = requestedPath;
+        std::vector<std::string> neighbors = neighborPaths;
+        hasRequest = false;
+        loading = true;
+        
+        lock.unlock();
+        std::string key = cacheKey(path);
+        lock.lock();
+        
+        // Árvore em cache (lida antes ou pré-carregada): entrega imediata
+        std::shared_ptr<const TreeModel> tree;
+        if (std::shared_ptr<const TreeModel>* cached = cache.find(key)) {
+            tree = *cached;
+        } else {
+            lock.unlock();
+            tree = loadTree(path);
+            lock.lock();
+            if (tree) cache.insert(key, tree, tree->memoryUsage());
+        }
+        
+        // Se um pedido mais novo chegou durante a leitura, esta árvore fica só no cache
+        if (!hasRequest) {
+            ready.path = path;
+            ready.cacheKey = key;
+            ready.tree = tree;
+            hasReady = true;
+        }
+        
+        // Pré-carrega vizinhas, interrompendo se o usuário já pediu outra árvore
+        for (const std::string& neighbor : neighbors) {
+            if (!running || hasRequest) break;
+            
+            lock.unlock();
+            std::string neighborKey = cacheKey(neighbor);
+            lock.lock();
+            if (cache.contains(neighborKey)) continue;
+            
+            lock.unlock();
+            std::shared_ptr<const TreeModel> neighborTree = loadTree(neighbor);
+            lock.lock();
+            
+            if (neighborTree) cache.insert(neighborKey, neighborTree, neighborTree->memoryUsage());
+        }
+        
+        loading = false;
+    }
+}
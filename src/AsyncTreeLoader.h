@@ -0,0 +1,73 @@
+#ifndef ASYNCTREELOADER_H
+#define ASYNCTREELOADER_H
+
+#include "VTKLoader.h"
+#include "LRUCache.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Árvore lida de um arquivo, com a chave usada nos caches
+struct LoadedTree {
+    std::string path;
+    std::string cacheKey;
+    std::shared_ptr<const TreeModel> tree;     // nulo se a leitura falhou
+};
+
+// Carrega árvores em uma thread de trabalho enquanto a atual continua sendo
+// renderizada. Depois de cada pedido, os arquivos vizinhos da lista são
+// pré-carregados para que a navegação com as setas não espere pela leitura.
+// As árvores lidas ficam em um cache LRU com orçamento de memória, indexado
+// pelo caminho e pela data de modificação do arquivo.
+class AsyncTreeLoader {
+public:
+    AsyncTreeLoader();
+    ~AsyncTreeLoader();
+    
+    AsyncTreeLoader(const AsyncTreeLoader&) = delete;
+    AsyncTreeLoader& operator=(const AsyncTreeLoader&) = delete;
+    
+    void start();
+    void stop();
+    
+    // Pede files[index]; um pedido novo substitui o anterior ainda não atendido
+    void request(const std::vector<std::string>& files, size_t index);
+    
+    // Entrega a árvore pedida mais recente quando fica pronta (uma única vez)
+    bool takeReady(LoadedTree& result);
+    bool isLoading() const;
+    
+    void setCacheBudget(size_t bytes);
+    CacheStats getCacheStats() const;
+    
+    // Caminho mais data de modificação: um arquivo regravado gera outra chave
+    static std::string cacheKey(const std::string& path);
+    
+    static constexpr size_t defaultCacheBudget = 512u * 1024u * 1024u;
+    
+private:
+    void workerLoop();
+    std::shared_ptr<const TreeModel> loadTree(const std::string& path);
+    
+    std::thread worker;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    bool running;
+    
+    // Pedido pendente e vizinhos a pré-carregar
+    bool hasRequest;
+    std::string requestedPath;
+    std::vector<std::string> neighborPaths;
+    bool loading;
+    
+    // Resultado entregue ao laço principal
+    bool hasReady;
+    LoadedTree ready;
+    
+    LRUCache<std::shared_ptr<const TreeModel>> cache;
+};
+
+#endif
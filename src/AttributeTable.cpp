@@ -0,0 +1,94 @@
+#include "AttributeTable.h"
+#include "MappedFile.h"
+#include <iostream>
+
+AttributeTable::AttributeTable() : sourceSize(0) {}
+
+void AttributeTable::setSourceFile(const std::string& path, uint64_t size) {
+    sourcePath = path;
+    sourceSize = size;
+}
+
+void AttributeTable::add(Column column) {
+    std::lock_guard<std::mutex> lock(mutex);
+    columns.push_back(std::move(column));
+    loaded.emplace_back();
+    failed.push_back(false);
+}
+
+void AttributeTable::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    columns.clear();
+    loaded.clear();
+    failed.clear();
+    sourcePath.clear();
+    sourceSize = 0;
+}
+
+int AttributeTable::find(const std::string& name) const {
+    for (size_t i = 0; i < columns.size(); i++) {
+        if (columns[i].name == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+const std::vector<float>* AttributeTable::values(size_t index) const {
+    return load(index, nullptr, 0);
+}
+
+const std::vector<float>* AttributeTable::values(size_t index, const char* data, size_t dataSize) const {
+    return load(index, data, dataSize);
+}
+
+bool AttributeTable::isLoaded(size_t index) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return index < loaded.size() && loaded[index];
+}
+
+size_t AttributeTable::memoryUsage() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t bytes = columns.capacity() * sizeof(Column);
+    for (const auto& values : loaded) {
+        if (values) bytes += values->capacity() * sizeof(float);
+    }
+    return bytes;
+}
+
+const std::vector<float>* AttributeTable::load(size_t index, const char* data, size_t dataSize) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (index >= columns.size() || failed[index]) return nullptr;
+    if (loaded[index]) return loaded[index].get();
+    
+    // Sem o arquivo em mãos, mapeia a origem; o tamanho confere que ela não
+    // foi substituída desde a leitura da árvore
+    MappedFile file;
+    if (!data) {
+        if (!file.open(sourcePath) || file.size() != sourceSize) {
+            std::cout << "[!] Arquivo de origem do atributo mudou ou sumiu: " << sourcePath << std::endl;
+            failed[index] = true;
+            return nullptr;
+        }
+        data = file.data();
+        dataSize = file.size();
+    }
+    
+    const Column& column = columns[index];
+    auto values = std::make_unique<std::vector<float>>(column.valueCount());
+    size_t offset = 0;
+    for (const ArraySource& source : column.sources) {
+        if (offset + source.count > values->size() ||
+            !readArraySource(data, dataSize, source, values->data() + offset)) {
+            std::cout << "[!] Array de atributo inválido: " << column.name << std::endl;
+            failed[index] = true;
+            return nullptr;
+        }
+        offset += static_cast<size_t>(source.count);
+    }
+    if (offset != values->size()) {
+        failed[index] = true;
+        return nullptr;
+    }
+    
+    loaded[index] = std::move(values);
+    return loaded[index].get();
+}
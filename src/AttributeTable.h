@@ -0,0 +1,67 @@
+#ifndef ATTRIBUTETABLE_H
+#define ATTRIBUTETABLE_H
+
+#include "ArrayDecoding.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+// Associação de um array de atributo: um valor (ou tupla) por ponto, por
+// célula, ou dados de campo sem associação com a geometria
+enum class AttributeLocation : uint8_t { PointData, CellData, FieldData };
+
+// Tabela colunar com todos os arrays de atributo de um arquivo (SCALARS,
+// FIELD, PointData/CellData do .vtp). Na leitura do arquivo só se registra
+// onde estão os bytes de cada array; os valores são lidos na primeira vez
+// que alguém os pede, a partir do arquivo de origem.
+class AttributeTable {
+public:
+    struct Column {
+        std::string name;
+        AttributeLocation location = AttributeLocation::PointData;
+        int components = 1;
+        size_t tupleCount = 0;
+        std::vector<ArraySource> sources;   // um trecho por peça do arquivo, em ordem
+        
+        size_t valueCount() const { return tupleCount * static_cast<size_t>(components); }
+    };
+    
+    AttributeTable();
+    AttributeTable(const AttributeTable&) = delete;
+    AttributeTable& operator=(const AttributeTable&) = delete;
+    
+    void setSourceFile(const std::string& path, uint64_t size);
+    const std::string& getSourceFile() const { return sourcePath; }
+    uint64_t getSourceSize() const { return sourceSize; }
+    
+    void add(Column column);
+    void clear();
+    
+    size_t size() const { return columns.size(); }
+    const Column& column(size_t index) const { return columns[index]; }
+    int find(const std::string& name) const;      // -1 se não existir
+    
+    // Valores do array (tupla após tupla), lidos do arquivo de origem no
+    // primeiro pedido; nullptr se o arquivo mudou ou o array é inválido.
+    // Seguro para várias threads; o vetor devolvido não muda depois de lido.
+    const std::vector<float>* values(size_t index) const;
+    // O mesmo, usando o arquivo já mapeado por quem está lendo a árvore
+    const std::vector<float>* values(size_t index, const char* data, size_t dataSize) const;
+    bool isLoaded(size_t index) const;
+    
+    size_t memoryUsage() const;     // bytes dos arrays já lidos
+
+private:
+    const std::vector<float>* load(size_t index, const char* data, size_t dataSize) const;
+    
+    std::vector<Column> columns;
+    std::string sourcePath;
+    uint64_t sourceSize;
+    
+    mutable std::mutex mutex;
+    mutable std::vector<std::unique_ptr<std::vector<float>>> loaded;
+    mutable std::vector<bool> failed;
+};
+
+#endif
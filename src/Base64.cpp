@@ -0,0 +1,136 @@
+#include "Base64.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define TP1_BASE64_AVX2 1
+#endif
+
+namespace {
+
+// Valor de 6 bits de cada caractere; 64 marca branco, 255 marca inválido
+struct DecodeTable {
+    uint8_t value[256];
+    
+    DecodeTable() {
+        for (int i = 0; i < 256; i++) value[i] = 255;
+        const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int i = 0; i < 64; i++) value[static_cast<uint8_t>(alphabet[i])] = static_cast<uint8_t>(i);
+        value[static_cast<uint8_t>(' ')] = 64;
+        value[static_cast<uint8_t>('\n')] = 64;
+        value[static_cast<uint8_t>('\r')] = 64;
+        value[static_cast<uint8_t>('\t')] = 64;
+    }
+};
+
+const DecodeTable decodeTable;
+
+// Decodificador de referência, um caractere por vez
+size_t decodeScalar(const char* input, size_t length, uint8_t* output, size_t capacity, size_t& position) {
+    uint32_t bits = 0;
+    int pending = 0;
+    size_t written = 0;
+    
+    for (; position < length; position++) {
+        uint8_t v = decodeTable.value[static_cast<uint8_t>(input[position])];
+        if (v == 64) continue;
+        if (v == 255) break;
+        
+        bits = (bits << 6) | v;
+        pending++;
+        if (pending == 4) {
+            if (written + 3 > capacity) break;
+            output[written++] = static_cast<uint8_t>(bits >> 16);
+            output[written++] = static_cast<uint8_t>(bits >> 8);
+            output[written++] = static_cast<uint8_t>(bits);
+            bits = 0;
+            pending = 0;
+        }
+    }
+    
+    // Grupo final incompleto (antes do '=')
+    if (pending >= 2 && written < capacity) {
+        bits <<= 6 * (4 - pending);
+        output[written++] = static_cast<uint8_t>(bits >> 16);
+        if (pending == 3 && written < capacity) output[written++] = static_cast<uint8_t>(bits >> 8);
+    }
+    return written;
+}
+
+#ifdef TP1_BASE64_AVX2
+
+// 32 caracteres viram 24 bytes por iteração. Classifica cada caractere pelos
+// nibbles alto e baixo, converte para 6 bits somando um deslocamento por faixa
+// e junta os bits com multiplicações. Qualquer caractere fora do alfabeto
+// (branco, '=', fim do texto) devolve o controle ao laço escalar.
+__attribute__((target("avx2")))
+size_t decodeAVX2(const char* input, size_t length, uint8_t* output, size_t capacity, size_t& position) {
+    const __m256i lutLow = _mm256_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lutHigh = _mm256_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lutRoll = _mm256_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+    const __m256i slash = _mm256_set1_epi8('/');
+    const __m256i mergePairs = _mm256_set1_epi32(0x01400140);
+    const __m256i mergeQuads = _mm256_set1_epi32(0x00011000);
+    const __m256i packBytes = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i packLanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+    
+    size_t written = 0;
+    // Grava 32 bytes para aproveitar 24; exige folga no destino
+    while (position + 32 <= length && written + 32 <= capacity) {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + position));
+        __m256i high = _mm256_and_si256(_mm256_srli_epi32(in, 4), nibbleMask);
+        __m256i low = _mm256_and_si256(in, nibbleMask);
+        __m256i invalid = _mm256_and_si256(_mm256_shuffle_epi8(lutLow, low), _mm256_shuffle_epi8(lutHigh, high));
+        if (!_mm256_testz_si256(invalid, invalid)) break;
+        
+        __m256i roll = _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(_mm256_cmpeq_epi8(in, slash), high));
+        __m256i sextets = _mm256_add_epi8(in, roll);
+        __m256i merged = _mm256_madd_epi16(_mm256_maddubs_epi16(sextets, mergePairs), mergeQuads);
+        __m256i packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(merged, packBytes), packLanes);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + written), packed);
+        
+        position += 32;
+        written += 24;
+    }
+    return written + decodeScalar(input, length, output + written, capacity - written, position);
+}
+
+#endif
+
+typedef size_t (*DecodeKernel)(const char*, size_t, uint8_t*, size_t, size_t&);
+
+DecodeKernel selectKernel(bool avx2) {
+#ifdef TP1_BASE64_AVX2
+    __builtin_cpu_init();
+    if (avx2 && __builtin_cpu_supports("avx2")) return decodeAVX2;
+#endif
+    (void)avx2;
+    return decodeScalar;
+}
+
+DecodeKernel& kernel() {
+    static DecodeKernel selected = selectKernel(true);
+    return selected;
+}
+
+} // namespace
+
+size_t decodeBase64(const char* input, size_t length, uint8_t* output, size_t capacity, size_t* consumed) {
+    size_t position = 0;
+    size_t written = kernel()(input, length, output, capacity, position);
+    if (consumed) *consumed = position;
+    return written;
+}
+
+bool setBase64AVX2(bool enabled) {
+    kernel() = selectKernel(enabled);
+    return kernel() != decodeScalar;
+}
@@ -0,0 +1,19 @@
+#ifndef BASE64_H
+#define BASE64_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Decodifica base64 padrão (A-Z a-z 0-9 + /) em output, escrevendo no máximo
+// capacity bytes. Espaços em branco são ignorados; para no primeiro '=' ou em
+// qualquer outro caractere inválido. Retorna o número de bytes escritos e, se
+// consumed não for nulo, quantos caracteres da entrada foram lidos. Blocos de
+// 32 caracteres são decodificados com AVX2 quando o processador suporta.
+size_t decodeBase64(const char* input, size_t length, uint8_t* output, size_t capacity,
+                    size_t* consumed = nullptr);
+
+// Liga ou desliga o kernel AVX2 (os testes comparam com o laço escalar).
+// Retorna true se o AVX2 ficou em uso. Não chamar durante uma leitura.
+bool setBase64AVX2(bool enabled);
+
+#endif
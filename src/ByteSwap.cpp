@@ -0,0 +1,118 @@
+#include "ByteSwap.h"
+#include <cstring>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define TP1_BYTESWAP_AVX2 1
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define TP1_BIG_ENDIAN_HOST 1
+#endif
+
+namespace {
+
+typedef void (*CopyKernel)(const char* source, size_t count, char* destination);
+
+void copySwap32Scalar(const char* source, size_t count, char* destination) {
+    for (size_t i = 0; i < count; i++) {
+        uint32_t word;
+        std::memcpy(&word, source + i * 4, 4);
+        word = __builtin_bswap32(word);
+        std::memcpy(destination + i * 4, &word, 4);
+    }
+}
+
+void copySwap64Scalar(const char* source, size_t count, char* destination) {
+    for (size_t i = 0; i < count; i++) {
+        uint64_t word;
+        std::memcpy(&word, source + i * 8, 8);
+        word = __builtin_bswap64(word);
+        std::memcpy(destination + i * 8, &word, 8);
+    }
+}
+
+#ifdef TP1_BYTESWAP_AVX2
+
+// 32 bytes por instrução de embaralhamento; o resto vai pelo laço escalar
+__attribute__((target("avx2")))
+void copySwap32AVX2(const char* source, size_t count, char* destination) {
+    const __m256i order = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                           3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * 4));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * 4 + 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i * 4), _mm256_shuffle_epi8(a, order));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i * 4 + 32), _mm256_shuffle_epi8(b, order));
+    }
+    for (; i + 8 <= count; i += 8) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i * 4), _mm256_shuffle_epi8(a, order));
+    }
+    copySwap32Scalar(source + i * 4, count - i, destination + i * 4);
+}
+
+__attribute__((target("avx2")))
+void copySwap64AVX2(const char* source, size_t count, char* destination) {
+    const __m256i order = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                           7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i * 8), _mm256_shuffle_epi8(a, order));
+    }
+    copySwap64Scalar(source + i * 8, count - i, destination + i * 8);
+}
+
+#endif
+
+struct SwapKernels {
+    CopyKernel swap32 = copySwap32Scalar;
+    CopyKernel swap64 = copySwap64Scalar;
+    
+    SwapKernels() { useAVX2(true); }
+    
+    bool useAVX2(bool enabled) {
+        swap32 = copySwap32Scalar;
+        swap64 = copySwap64Scalar;
+#ifdef TP1_BYTESWAP_AVX2
+        __builtin_cpu_init();
+        if (enabled && __builtin_cpu_supports("avx2")) {
+            swap32 = copySwap32AVX2;
+            swap64 = copySwap64AVX2;
+            return true;
+        }
+#endif
+        (void)enabled;
+        return false;
+    }
+};
+
+SwapKernels& kernels() {
+    static SwapKernels selected;
+    return selected;
+}
+
+} // namespace
+
+void copyBigEndian32(const void* source, size_t count, void* destination) {
+#ifdef TP1_BIG_ENDIAN_HOST
+    std::memcpy(destination, source, count * 4);
+#else
+    kernels().swap32(static_cast<const char*>(source), count, static_cast<char*>(destination));
+#endif
+}
+
+void copyBigEndian64(const void* source, size_t count, void* destination) {
+#ifdef TP1_BIG_ENDIAN_HOST
+    std::memcpy(destination, source, count * 8);
+#else
+    kernels().swap64(static_cast<const char*>(source), count, static_cast<char*>(destination));
+#endif
+}
+
+bool setByteSwapAVX2(bool enabled) {
+    return kernels().useAVX2(enabled);
+}
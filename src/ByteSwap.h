@@ -0,0 +1,16 @@
+#ifndef BYTESWAP_H
+#define BYTESWAP_H
+
+#include <cstddef>
+
+// Copia count valores big-endian (como nos blocos BINARY do VTK legado) para
+// destination, já na ordem de bytes da máquina. Usa AVX2 quando disponível.
+// destination não precisa estar alinhado, mas não pode sobrepor source.
+void copyBigEndian32(const void* source, size_t count, void* destination);
+void copyBigEndian64(const void* source, size_t count, void* destination);
+
+// Liga ou desliga os kernels AVX2 (os testes comparam com o laço escalar).
+// Retorna true se o AVX2 ficou em uso. Não chamar durante uma leitura.
+bool setByteSwapAVX2(bool enabled);
+
+#endif
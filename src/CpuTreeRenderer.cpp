@@ -0,0 +1,334 @@
+#include "CpuTreeRenderer.h"
+#include "ParallelFor.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define TP1_CPU_AVX2 1
+#endif
+
+namespace {
+
+const int tileSize = 64;
+
+// Mesmas cores e espessuras de segmentStyleSource em TreeRenderer.cpp
+void segmentColor(int colorMode, float normalizedDepth, float normalizedDescendants, float* color) {
+    if (colorMode == 1) {
+        color[0] = 0.0f; color[1] = 1.0f; color[2] = 0.0f;
+    } else if (colorMode == 2) {
+        color[0] = 1.0f - normalizedDepth * 0.5f;
+        color[1] = 0.0f;
+        color[2] = normalizedDepth * 0.5f;
+    } else if (colorMode == 3) {
+        color[0] = std::sqrt(normalizedDescendants);
+        color[1] = 0.0f;
+        color[2] = 1.0f - normalizedDescendants * normalizedDescendants;
+    } else {
+        color[0] = color[1] = color[2] = 1.0f;
+    }
+}
+
+float segmentThickness(bool thicknessMode, float lineWidth, float normalizedDescendants) {
+    float thickness = thicknessMode ? 2.0f + normalizedDescendants * 13.0f : lineWidth;
+    return std::clamp(thickness, 1.0f, 10.0f);
+}
+
+// Cobertura de count pixels consecutivos de uma linha; (x, y) é o centro do
+// primeiro pixel relativo ao início do segmento. Mesma função de distância
+// do shader de vasos.
+void coverageSpanScalar(const CpuTreeRenderer::CapsuleShape& s, float x, float y, int count, float* coverage) {
+    for (int i = 0; i < count; i++) {
+        float px = x + static_cast<float>(i);
+        float dist;
+        if (s.circle) {
+            dist = std::sqrt(px * px + y * y) - s.ra;
+        } else {
+            float qx = std::abs(px * s.by - y * s.bx) * s.invH;
+            float qy = (px * s.bx + y * s.by) * s.invH;
+            float k = s.cx * qy - s.cy * qx;
+            float m = s.cx * qx + s.cy * qy;
+            float n = qx * qx + qy * qy;
+            
+            if (k < 0.0f) dist = std::sqrt(s.h * n) - s.ra;
+            else if (k > s.cx) dist = std::sqrt(std::max(s.h * (n + 1.0f - 2.0f * qy), 0.0f)) - s.rb;
+            else dist = m - s.ra;
+        }
+        coverage[i] = std::clamp(0.5f - dist, 0.0f, 1.0f);
+    }
+}
+
+#ifdef TP1_CPU_AVX2
+
+// Oito pixels por iteração; count deve ser múltiplo de 8
+__attribute__((target("avx2,fma")))
+void coverageSpanAVX2(const CpuTreeRenderer::CapsuleShape& s, float x, float y, int count, float* coverage) {
+    const __m256 lane = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 ra = _mm256_set1_ps(s.ra);
+    const __m256 rb = _mm256_set1_ps(s.rb);
+    
+    if (s.circle) {
+        const __m256 yy = _mm256_set1_ps(y * y);
+        for (int i = 0; i < count; i += 8) {
+            __m256 px = _mm256_add_ps(_mm256_set1_ps(x + static_cast<float>(i)), lane);
+            __m256 dist = _mm256_sub_ps(_mm256_sqrt_ps(_mm256_fmadd_ps(px, px, yy)), ra);
+            __m256 cov = _mm256_min_ps(_mm256_max_ps(_mm256_sub_ps(half, dist), zero), one);
+            _mm256_storeu_ps(coverage + i, cov);
+        }
+        return;
+    }
+    
+    const __m256 bx = _mm256_set1_ps(s.bx);
+    const __m256 by = _mm256_set1_ps(s.by);
+    const __m256 yBx = _mm256_set1_ps(y * s.bx);
+    const __m256 yBy = _mm256_set1_ps(y * s.by);
+    const __m256 invH = _mm256_set1_ps(s.invH);
+    const __m256 h = _mm256_set1_ps(s.h);
+    const __m256 cx = _mm256_set1_ps(s.cx);
+    const __m256 cy = _mm256_set1_ps(s.cy);
+    
+    for (int i = 0; i < count; i += 8) {
+        __m256 px = _mm256_add_ps(_mm256_set1_ps(x + static_cast<float>(i)), lane);
+        __m256 qx = _mm256_mul_ps(_mm256_andnot_ps(signMask, _mm256_fmsub_ps(px, by, yBx)), invH);
+        __m256 qy = _mm256_mul_ps(_mm256_fmadd_ps(px, bx, yBy), invH);
+        __m256 k = _mm256_fmsub_ps(cx, qy, _mm256_mul_ps(cy, qx));
+        __m256 m = _mm256_fmadd_ps(cx, qx, _mm256_mul_ps(cy, qy));
+        __m256 n = _mm256_fmadd_ps(qx, qx, _mm256_mul_ps(qy, qy));
+        
+        __m256 startDist = _mm256_sub_ps(_mm256_sqrt_ps(_mm256_mul_ps(h, n)), ra);
+        __m256 endTerm = _mm256_fnmadd_ps(_mm256_add_ps(qy, qy), one, _mm256_add_ps(n, one));
+        __m256 endDist = _mm256_sub_ps(_mm256_sqrt_ps(_mm256_max_ps(_mm256_mul_ps(h, endTerm), zero)), rb);
+        
+        __m256 dist = _mm256_sub_ps(m, ra);
+        dist = _mm256_blendv_ps(dist, endDist, _mm256_cmp_ps(k, cx, _CMP_GT_OQ));
+        dist = _mm256_blendv_ps(dist, startDist, _mm256_cmp_ps(k, zero, _CMP_LT_OQ));
+        
+        __m256 cov = _mm256_min_ps(_mm256_max_ps(_mm256_sub_ps(half, dist), zero), one);
+        _mm256_storeu_ps(coverage + i, cov);
+    }
+}
+
+#endif
+
+} // namespace
+
+CpuTreeRenderer::CpuTreeRenderer()
+    : width(0), height(0), tilesX(0), tilesY(0),
+      clearColor{0.0f, 0.0f, 0.0f}, threadCount(0),
+      coverageKernel(coverageSpanScalar) {}
+
+CpuTreeRenderer::~CpuTreeRenderer() {
+    cleanup();
+}
+
+bool CpuTreeRenderer::initialize() {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    
+    const char* kernelName = "escalar";
+    coverageKernel = coverageSpanScalar;
+#ifdef TP1_CPU_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        coverageKernel = coverageSpanAVX2;
+        kernelName = "AVX2";
+    }
+#endif
+
+    std::cout << "Renderizador em CPU: " << threadCount << " threads, cobertura "
+              << kernelName << std::endl;
+    return true;
+}
+
+void CpuTreeRenderer::cleanup() {
+    tree = SegmentData();
+    shapes.clear();
+    bins.clear();
+    image.clear();
+}
+
+void CpuTreeRenderer::setViewport(int w, int h) {
+    width = std::max(w, 0);
+    height = std::max(h, 0);
+    tilesX = (width + tileSize - 1) / tileSize;
+    tilesY = (height + tileSize - 1) / tileSize;
+}
+
+void CpuTreeRenderer::setClearColor(float r, float g, float b) {
+    clearColor[0] = r;
+    clearColor[1] = g;
+    clearColor[2] = b;
+}
+
+void CpuTreeRenderer::setThreadCount(unsigned int count) {
+    threadCount = count;
+}
+
+void CpuTreeRenderer::prepareTree(SegmentData&& data) {
+    tree = std::move(data);
+}
+
+void CpuTreeRenderer::render() {
+    image.assign(static_cast<size_t>(width) * height * 4, 255);
+    if (width == 0 || height == 0) return;
+    
+    size_t tileCount = static_cast<size_t>(tilesX) * tilesY;
+    size_t chunkCount = std::max(1u, threadCount);
+    shapes.resize(tree.segmentCount);
+    bins.resize(chunkCount * tileCount);
+    
+    // Os segmentos são divididos em blocos contíguos, um por thread; cada bloco
+    // tem suas próprias listas por bloco da tela, percorridas depois na ordem
+    // dos blocos para manter a ordem de desenho da GPU
+    parallelFor(threadCount, chunkCount, [this](size_t chunk) { binSegments(chunk); });
+    parallelFor(threadCount, tileCount, [this](size_t tile) { rasterizeTile(static_cast<int>(tile)); });
+}
+
+void CpuTreeRenderer::binSegments(size_t chunk) {
+    size_t chunkCount = std::max(1u, threadCount);
+    size_t tileCount = static_cast<size_t>(tilesX) * tilesY;
+    size_t begin = tree.segmentCount * chunk / chunkCount;
+    size_t end = tree.segmentCount * (chunk + 1) / chunkCount;
+    
+    std::vector<int>* chunkBins = &bins[chunk * tileCount];
+    for (size_t tile = 0; tile < tileCount; tile++) {
+        chunkBins[tile].clear();
+    }
+    
+    float halfWidth = 0.5f * static_cast<float>(width);
+    float halfHeight = 0.5f * static_cast<float>(height);
+    float pixelsPerUnit = std::sqrt(transform[0] * transform[0] + transform[1] * transform[1]) *
+                          std::sqrt(halfWidth * halfHeight);
+    int mode = colorMode();
+    
+    for (size_t i = begin; i < end; i++) {
+        const float* v = &tree.vertices[i * 4];
+        CapsuleShape& s = shapes[i];
+        
+        // Transformação da câmera e conversão para pixels, com y para baixo
+        float ax = (transform[0] * v[0] + transform[4] * v[1] + transform[12] + 1.0f) * halfWidth;
+        float ay = (1.0f - (transform[1] * v[0] + transform[5] * v[1] + transform[13])) * halfHeight;
+        float bx = (transform[0] * v[2] + transform[4] * v[3] + transform[12] + 1.0f) * halfWidth;
+        float by = (1.0f - (transform[1] * v[2] + transform[5] * v[3] + transform[13])) * halfHeight;
+        
+        float ra, rb;
+        if (vesselMode) {
+            ra = std::max(tree.radii[i * 2] * tree.radiusScale * pixelsPerUnit, 0.5f);
+            rb = std::max(tree.radii[i * 2 + 1] * tree.radiusScale * pixelsPerUnit, 0.5f);
+        } else {
+            ra = rb = 0.5f * segmentThickness(thicknessMode, lineWidth, tree.normalizedDescendants[i]);
+        }
+        
+        s.ax = ax;
+        s.ay = ay;
+        s.bx = bx - ax;
+        s.by = by - ay;
+        s.ra = ra;
+        s.rb = rb;
+        s.h = s.bx * s.bx + s.by * s.by;
+        float b = ra - rb;
+        s.circle = s.h <= b * b;
+        if (s.circle) {
+            // A cápsula é o maior dos dois círculos
+            if (rb > ra) {
+                s.ax = bx;
+                s.ay = by;
+                s.ra = rb;
+            }
+        } else {
+            s.invH = 1.0f / s.h;
+            s.cx = std::sqrt(s.h - b * b);
+            s.cy = b;
+        }
+        
+        float margin = std::max(ra, rb) + 1.0f;
+        s.minX = std::min(ax, bx) - margin;
+        s.minY = std::min(ay, by) - margin;
+        s.maxX = std::max(ax, bx) + margin;
+        s.maxY = std::max(ay, by) + margin;
+        segmentColor(mode, tree.normalizedDepth[i], tree.normalizedDescendants[i], s.color);
+        
+        if (s.maxX < 0.0f || s.maxY < 0.0f || s.minX >= width || s.minY >= height) continue;
+        
+        int tileX0 = static_cast<int>(std::max(s.minX, 0.0f)) / tileSize;
+        int tileY0 = static_cast<int>(std::max(s.minY, 0.0f)) / tileSize;
+        int tileX1 = std::min(static_cast<int>(std::min(s.maxX, static_cast<float>(width))) / tileSize, tilesX - 1);
+        int tileY1 = std::min(static_cast<int>(std::min(s.maxY, static_cast<float>(height))) / tileSize, tilesY - 1);
+        for (int ty = tileY0; ty <= tileY1; ty++) {
+            for (int tx = tileX0; tx <= tileX1; tx++) {
+                chunkBins[ty * tilesX + tx].push_back(static_cast<int>(i));
+            }
+        }
+    }
+}
+
+void CpuTreeRenderer::rasterizeTile(int tile) {
+    // Canais separados para que a mistura seja vetorizada pelo compilador
+    alignas(32) float red[tileSize * tileSize];
+    alignas(32) float green[tileSize * tileSize];
+    alignas(32) float blue[tileSize * tileSize];
+    alignas(32) float coverage[tileSize];
+    
+    std::fill_n(red, tileSize * tileSize, clearColor[0]);
+    std::fill_n(green, tileSize * tileSize, clearColor[1]);
+    std::fill_n(blue, tileSize * tileSize, clearColor[2]);
+    
+    int originX = (tile % tilesX) * tileSize;
+    int originY = (tile / tilesX) * tileSize;
+    size_t tileCount = static_cast<size_t>(tilesX) * tilesY;
+    
+    for (size_t chunk = 0; chunk * tileCount < bins.size(); chunk++) {
+        for (int index : bins[chunk * tileCount + tile]) {
+            const CapsuleShape& s = shapes[index];
+            
+            // Trecho da caixa do segmento dentro do bloco, alinhado a 8 pixels
+            float tileMinX = static_cast<float>(originX);
+            float tileMinY = static_cast<float>(originY);
+            float tileMaxX = tileMinX + tileSize;
+            float tileMaxY = tileMinY + tileSize;
+            int x0 = static_cast<int>(std::floor(std::clamp(s.minX, tileMinX, tileMaxX))) - originX;
+            int x1 = static_cast<int>(std::ceil(std::clamp(s.maxX, tileMinX, tileMaxX))) - originX;
+            int y0 = static_cast<int>(std::floor(std::clamp(s.minY, tileMinY, tileMaxY))) - originY;
+            int y1 = static_cast<int>(std::ceil(std::clamp(s.maxY, tileMinY, tileMaxY))) - originY;
+            x0 &= ~7;
+            if (x1 <= x0 || y1 <= y0) continue;
+            x1 = (x1 + 7) & ~7;
+            int count = x1 - x0;
+            
+            float startX = static_cast<float>(originX + x0) + 0.5f - s.ax;
+            for (int y = y0; y < y1; y++) {
+                float startY = static_cast<float>(originY + y) + 0.5f - s.ay;
+                coverageKernel(s, startX, startY, count, coverage);
+                
+                float* r = red + y * tileSize + x0;
+                float* g = green + y * tileSize + x0;
+                float* b = blue + y * tileSize + x0;
+                for (int i = 0; i < count; i++) {
+                    float a = coverage[i];
+                    r[i] += (s.color[0] - r[i]) * a;
+                    g[i] += (s.color[1] - g[i]) * a;
+                    b[i] += (s.color[2] - b[i]) * a;
+                }
+            }
+        }
+    }
+    
+    int visibleWidth = std::min(tileSize, width - originX);
+    int visibleHeight = std::min(tileSize, height - originY);
+    for (int y = 0; y < visibleHeight; y++) {
+        uint8_t* out = &image[(static_cast<size_t>(originY + y) * width + originX) * 4];
+        for (int x = 0; x < visibleWidth; x++) {
+            int i = y * tileSize + x;
+            out[x * 4 + 0] = static_cast<uint8_t>(red[i] * 255.0f + 0.5f);
+            out[x * 4 + 1] = static_cast<uint8_t>(green[i] * 255.0f + 0.5f);
+            out[x * 4 + 2] = static_cast<uint8_t>(blue[i] * 255.0f + 0.5f);
+        }
+    }
+}
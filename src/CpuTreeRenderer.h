@@ -0,0 +1,63 @@
+#ifndef CPUTREERENDERER_H
+#define CPUTREERENDERER_H
+
+#include "TreeRenderBackend.h"
+#include <vector>
+#include <cstdint>
+
+// Renderizador sem OpenGL: rasteriza cada segmento como cápsula afunilada
+// suavizada em uma imagem RGBA. A tela é dividida em blocos de 64x64 pixels;
+// os segmentos são distribuídos pelos blocos e cada bloco é pintado por uma
+// thread, com o cálculo de cobertura em AVX2 quando o processador suporta.
+class CpuTreeRenderer : public TreeRenderBackend {
+public:
+    CpuTreeRenderer();
+    ~CpuTreeRenderer() override;
+    
+    bool initialize() override;
+    void cleanup() override;
+    void render() override;
+    
+    void setViewport(int width, int height);
+    void setClearColor(float r, float g, float b);
+    void setThreadCount(unsigned int count);
+    
+    // Imagem RGBA da última renderização, com a primeira linha no topo
+    const std::vector<uint8_t>& getImage() const { return image; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    
+    // Segmento já em pixels, com os termos da função de distância da cápsula
+    struct CapsuleShape {
+        float ax, ay;           // início
+        float bx, by;           // fim, relativo ao início
+        float ra, rb;           // raios inicial e final
+        float h, invH;          // comprimento ao quadrado e seu inverso
+        float cx, cy;           // direção da tangente externa
+        bool circle;            // um círculo contém o outro: só (ax, ay, ra)
+        float minX, minY, maxX, maxY;
+        float color[3];
+    };
+    
+    typedef void (*CoverageKernel)(const CapsuleShape& shape, float x, float y, int count, float* coverage);
+
+private:
+    void prepareTree(SegmentData&& data) override;
+    void binSegments(size_t chunk);
+    void rasterizeTile(int tile);
+    
+    SegmentData tree;
+    std::vector<CapsuleShape> shapes;
+    std::vector<std::vector<int>> bins;       // [bloco de segmentos][bloco da tela]
+    std::vector<uint8_t> image;
+    
+    int width;
+    int height;
+    int tilesX;
+    int tilesY;
+    float clearColor[3];
+    unsigned int threadCount;
+    CoverageKernel coverageKernel;
+};
+
+#endif
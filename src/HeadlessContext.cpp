@@ -0,0 +1,201 @@
+#include "HeadlessContext.h"
+#include <iostream>
+#include <cstring>
+
+#ifdef TP1_HEADLESS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#else
+#include "GLFW/glfw3.h"
+#endif
+
+HeadlessContext::HeadlessContext()
+    : width(0), height(0), framebuffer(0), colorBuffer(0),
+      display(nullptr), context(nullptr), window(nullptr) {}
+
+HeadlessContext::~HeadlessContext() {
+    cleanup();
+}
+
+bool HeadlessContext::initialize(int w, int h) {
+    cleanup();
+    width = w;
+    height = h;
+    
+    if (!createContext()) {
+        cleanup();
+        return false;
+    }
+    
+    if (!createFramebuffer()) {
+        cleanup();
+        return false;
+    }
+    
+    glViewport(0, 0, width, height);
+    return true;
+}
+
+void HeadlessContext::cleanup() {
+    if (context || window) {
+        if (framebuffer) glDeleteFramebuffers(1, &framebuffer);
+        if (colorBuffer) glDeleteRenderbuffers(1, &colorBuffer);
+    }
+    framebuffer = 0;
+    colorBuffer = 0;
+    destroyContext();
+}
+
+#ifdef TP1_HEADLESS_EGL
+
+bool HeadlessContext::createContext() {
+    // Prefere a plataforma surfaceless do Mesa, que não precisa de servidor gráfico
+    EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay) {
+        eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    
+    EGLint major = 0, minor = 0;
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+        eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+            std::cerr << "Falha ao inicializar EGL" << std::endl;
+            return false;
+        }
+    }
+    display = eglDisplay;
+    
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cerr << "EGL sem suporte a OpenGL desktop" << std::endl;
+        return false;
+    }
+    
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(eglDisplay, configAttributes, &config, 1, &configCount) || configCount == 0) {
+        std::cerr << "Nenhuma configuração EGL compatível" << std::endl;
+        return false;
+    }
+    
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttributes);
+    if (eglContext == EGL_NO_CONTEXT) {
+        std::cerr << "Falha ao criar contexto EGL: 0x" << std::hex << eglGetError() << std::dec << std::endl;
+        return false;
+    }
+    context = eglContext;
+    
+    // Sem superfície: todo o desenho vai para o framebuffer criado abaixo
+    if (!eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext)) {
+        std::cerr << "Falha ao ativar contexto EGL" << std::endl;
+        return false;
+    }
+    
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress))) {
+        std::cerr << "Falha ao iniciar GLAD" << std::endl;
+        return false;
+    }
+    
+    std::cout << "Contexto EGL " << major << "." << minor << ": "
+              << glGetString(GL_RENDERER) << std::endl;
+    return true;
+}
+
+void HeadlessContext::destroyContext() {
+    if (display) {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (context) eglDestroyContext(display, context);
+        eglTerminate(display);
+    }
+    display = nullptr;
+    context = nullptr;
+}
+
+#else
+
+bool HeadlessContext::createContext() {
+    if (!glfwInit()) {
+        std::cerr << "Falha ao inicializar GLFW (compile com HEADLESS=egl em máquinas sem display)" << std::endl;
+        return false;
+    }
+    
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    
+    GLFWwindow* hiddenWindow = glfwCreateWindow(1, 1, "TP1 - Exportação", NULL, NULL);
+    if (!hiddenWindow) {
+        std::cerr << "Falha ao criar janela GLFW oculta" << std::endl;
+        glfwTerminate();
+        return false;
+    }
+    window = hiddenWindow;
+    
+    glfwMakeContextCurrent(hiddenWindow);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cerr << "Falha ao iniciar GLAD" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void HeadlessContext::destroyContext() {
+    if (window) {
+        glfwDestroyWindow(static_cast<GLFWwindow*>(window));
+        glfwTerminate();
+    }
+    window = nullptr;
+}
+
+#endif
+
+bool HeadlessContext::createFramebuffer() {
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Framebuffer de exportação incompleto" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool HeadlessContext::readPixels(std::vector<uint8_t>& rgba) const {
+    if (!framebuffer) return false;
+    
+    size_t rowBytes = static_cast<size_t>(width) * 4;
+    rgba.resize(rowBytes * height);
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+    
+    // O OpenGL entrega a última linha primeiro
+    std::vector<uint8_t> row(rowBytes);
+    for (int top = 0, bottom = height - 1; top < bottom; top++, bottom--) {
+        uint8_t* a = rgba.data() + top * rowBytes;
+        uint8_t* b = rgba.data() + bottom * rowBytes;
+        std::memcpy(row.data(), a, rowBytes);
+        std::memcpy(a, b, rowBytes);
+        std::memcpy(b, row.data(), rowBytes);
+    }
+    return glGetError() == GL_NO_ERROR;
+}
@@ -0,0 +1,43 @@
+#ifndef HEADLESSCONTEXT_H
+#define HEADLESSCONTEXT_H
+
+#include <vector>
+#include <cstdint>
+#include "glad/glad.h"
+
+// Contexto OpenGL 3.3 sem janela, renderizando em um framebuffer próprio.
+// Com TP1_HEADLESS_EGL usa EGL (no Mesa, a plataforma surfaceless com
+// llvmpipe dispensa display e GPU); sem ele, recorre a uma janela GLFW oculta.
+class HeadlessContext {
+public:
+    HeadlessContext();
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    bool initialize(int width, int height);
+    void cleanup();
+
+    // Lê o framebuffer em RGBA, com a primeira linha no topo da imagem
+    bool readPixels(std::vector<uint8_t>& rgba) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    bool createContext();
+    void destroyContext();
+    bool createFramebuffer();
+
+    int width;
+    int height;
+    GLuint framebuffer;
+    GLuint colorBuffer;
+
+    void* display;
+    void* context;
+    void* window;
+};
+
+#endif
@@ -0,0 +1,315 @@
+#include "ImageWriter.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+uint32_t crcTable[256];
+bool crcTableReady = false;
+
+uint32_t updateCrc(uint32_t crc, const uint8_t* data, size_t length) {
+    if (!crcTableReady) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            crcTable[n] = c;
+        }
+        crcTableReady = true;
+    }
+    
+    for (size_t i = 0; i < length; i++) {
+        crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+void appendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void writeChunk(std::ofstream& file, const char type[4], const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> header;
+    appendBigEndian(header, static_cast<uint32_t>(data.size()));
+    header.insert(header.end(), type, type + 4);
+    
+    uint32_t crc = updateCrc(0xFFFFFFFFu, header.data() + 4, 4);
+    crc = updateCrc(crc, data.data(), data.size()) ^ 0xFFFFFFFFu;
+    
+    std::vector<uint8_t> footer;
+    appendBigEndian(footer, crc);
+    
+    file.write(reinterpret_cast<const char*>(header.data()), header.size());
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    file.write(reinterpret_cast<const char*>(footer.data()), footer.size());
+}
+
+uint32_t adler32(const std::vector<uint8_t>& data) {
+    // Redução módulo 65521 só a cada 5552 bytes, limite sem estouro de 32 bits
+    uint32_t a = 1, b = 0;
+    for (size_t begin = 0; begin < data.size(); begin += 5552) {
+        size_t end = std::min<size_t>(data.size(), begin + 5552);
+        for (size_t i = begin; i < end; i++) {
+            a += data[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+// Preditor de Paeth da especificação do PNG
+uint8_t paeth(int left, int up, int upLeft) {
+    int estimate = left + up - upLeft;
+    int distanceLeft = std::abs(estimate - left);
+    int distanceUp = std::abs(estimate - up);
+    int distanceUpLeft = std::abs(estimate - upLeft);
+    if (distanceLeft <= distanceUp && distanceLeft <= distanceUpLeft) return static_cast<uint8_t>(left);
+    if (distanceUp <= distanceUpLeft) return static_cast<uint8_t>(up);
+    return static_cast<uint8_t>(upLeft);
+}
+
+// Aplica à linha os cinco filtros do PNG e anexa a out o de menor soma dos
+// valores absolutos (com sinal), a heurística sugerida pela especificação
+void filterRow(const uint8_t* row, const uint8_t* previous, size_t rowBytes, size_t pixelBytes,
+               std::vector<uint8_t>& candidate, std::vector<uint8_t>& out) {
+    candidate.resize(rowBytes);
+    uint64_t bestCost = UINT64_MAX;
+    size_t bestStart = out.size();
+    out.resize(bestStart + rowBytes + 1);
+    
+    for (uint8_t filter = 0; filter < 5; filter++) {
+        uint64_t cost = 0;
+        for (size_t i = 0; i < rowBytes; i++) {
+            int left = i >= pixelBytes ? row[i - pixelBytes] : 0;
+            int up = previous ? previous[i] : 0;
+            int upLeft = (previous && i >= pixelBytes) ? previous[i - pixelBytes] : 0;
+            uint8_t predicted = 0;
+            switch (filter) {
+                case 1: predicted = static_cast<uint8_t>(left); break;
+                case 2: predicted = static_cast<uint8_t>(up); break;
+                case 3: predicted = static_cast<uint8_t>((left + up) / 2); break;
+                case 4: predicted = paeth(left, up, upLeft); break;
+            }
+            candidate[i] = static_cast<uint8_t>(row[i] - predicted);
+            cost += static_cast<uint64_t>(std::abs(static_cast<int8_t>(candidate[i])));
+        }
+        if (cost < bestCost) {
+            bestCost = cost;
+            out[bestStart] = filter;
+            std::copy(candidate.begin(), candidate.end(), out.begin() + bestStart + 1);
+        }
+    }
+}
+
+// Escrita de bits do deflate: o primeiro bit vai no bit menos significativo
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& output) : out(output) {}
+    
+    void write(uint32_t value, int count) {
+        buffer |= static_cast<uint64_t>(value) << bitCount;
+        bitCount += count;
+        while (bitCount >= 8) {
+            out.push_back(static_cast<uint8_t>(buffer));
+            buffer >>= 8;
+            bitCount -= 8;
+        }
+    }
+    
+    // Códigos de Huffman vão do bit mais significativo para o menos
+    void writeCode(uint32_t code, int length) {
+        uint32_t reversed = 0;
+        for (int i = 0; i < length; i++) {
+            reversed = (reversed << 1) | ((code >> i) & 1);
+        }
+        write(reversed, length);
+    }
+    
+    void flush() {
+        if (bitCount > 0) out.push_back(static_cast<uint8_t>(buffer));
+        buffer = 0;
+        bitCount = 0;
+    }
+    
+private:
+    std::vector<uint8_t>& out;
+    uint64_t buffer = 0;
+    int bitCount = 0;
+};
+
+const uint16_t lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t lengthExtraBits[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                     3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t distanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                   257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                   8193, 12289, 16385, 24577};
+const uint8_t distanceExtraBits[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                       7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// Símbolo de literal/comprimento no código fixo do deflate (RFC 1951, 3.2.6)
+void writeFixedSymbol(BitWriter& bits, int symbol) {
+    if (symbol < 144) bits.writeCode(0x30 + symbol, 8);
+    else if (symbol < 256) bits.writeCode(0x190 + symbol - 144, 9);
+    else if (symbol < 280) bits.writeCode(symbol - 256, 7);
+    else bits.writeCode(0xC0 + symbol - 280, 8);
+}
+
+void writeMatch(BitWriter& bits, int length, int distance) {
+    int lengthCode = static_cast<int>(std::upper_bound(lengthBase, lengthBase + 29, length) - lengthBase) - 1;
+    writeFixedSymbol(bits, 257 + lengthCode);
+    bits.write(static_cast<uint32_t>(length - lengthBase[lengthCode]), lengthExtraBits[lengthCode]);
+    
+    int distanceCode = static_cast<int>(std::upper_bound(distanceBase, distanceBase + 30, distance) - distanceBase) - 1;
+    bits.writeCode(static_cast<uint32_t>(distanceCode), 5);
+    bits.write(static_cast<uint32_t>(distance - distanceBase[distanceCode]), distanceExtraBits[distanceCode]);
+}
+
+// Um único bloco deflate com os códigos de Huffman fixos e LZ77 sobre uma
+// janela de 32 KB. As posições com os mesmos três bytes ficam encadeadas
+// por um hash; cada busca segue no máximo maxChain elos, o que basta para as
+// longas repetições do fundo e das linhas filtradas.
+void deflateFixed(const std::vector<uint8_t>& data, std::vector<uint8_t>& out) {
+    const int64_t windowSize = 32768;
+    const int hashBits = 15;
+    const int maxChain = 32;
+    const size_t maxLength = 258;
+    
+    std::vector<int64_t> head(size_t(1) << hashBits, -1);
+    std::vector<int64_t> previous(windowSize, -1);
+    auto hashAt = [&](size_t i) {
+        uint32_t key = data[i] | (data[i + 1] << 8) | (data[i + 2] << 16);
+        return (key * 2654435761u) >> (32 - hashBits);
+    };
+    auto insert = [&](size_t i) {
+        uint32_t h = hashAt(i);
+        previous[i & (windowSize - 1)] = head[h];
+        head[h] = static_cast<int64_t>(i);
+    };
+    
+    BitWriter bits(out);
+    bits.write(1, 1);   // último bloco
+    bits.write(1, 2);   // códigos fixos
+    
+    const size_t n = data.size();
+    size_t i = 0;
+    while (i < n) {
+        size_t bestLength = 0, bestDistance = 0;
+        if (i + 3 <= n) {
+            size_t limit = std::min(maxLength, n - i);
+            int64_t candidate = head[hashAt(i)];
+            for (int chain = 0; chain < maxChain && candidate >= 0 &&
+                                static_cast<int64_t>(i) - candidate <= windowSize; chain++) {
+                size_t length = 0;
+                const uint8_t* a = data.data() + candidate;
+                const uint8_t* b = data.data() + i;
+                while (length < limit && a[length] == b[length]) length++;
+                if (length > bestLength) {
+                    bestLength = length;
+                    bestDistance = i - static_cast<size_t>(candidate);
+                    if (length == limit) break;
+                }
+                candidate = previous[candidate & (windowSize - 1)];
+            }
+            insert(i);
+        }
+        
+        if (bestLength >= 3) {
+            writeMatch(bits, static_cast<int>(bestLength), static_cast<int>(bestDistance));
+            for (size_t j = i + 1; j < i + bestLength && j + 3 <= n; j++) insert(j);
+            i += bestLength;
+        } else {
+            writeFixedSymbol(bits, data[i]);
+            i++;
+        }
+    }
+    writeFixedSymbol(bits, 256);
+    bits.flush();
+}
+
+// Blocos "stored" de até 65535 bytes, para dados que não comprimem
+void deflateStored(const std::vector<uint8_t>& data, std::vector<uint8_t>& out) {
+    size_t offset = 0;
+    do {
+        size_t blockSize = std::min<size_t>(data.size() - offset, 65535);
+        bool last = offset + blockSize == data.size();
+        out.push_back(last ? 1 : 0);
+        out.push_back(static_cast<uint8_t>(blockSize));
+        out.push_back(static_cast<uint8_t>(blockSize >> 8));
+        out.push_back(static_cast<uint8_t>(~blockSize));
+        out.push_back(static_cast<uint8_t>(~blockSize >> 8));
+        out.insert(out.end(), data.begin() + offset, data.begin() + offset + blockSize);
+        offset += blockSize;
+    } while (offset < data.size());
+}
+
+} // namespace
+
+bool writePNG(const std::string& filename, int width, int height, const std::vector<uint8_t>& rgba) {
+    size_t rowBytes = static_cast<size_t>(width) * 4;
+    if (width <= 0 || height <= 0 || rgba.size() < rowBytes * height) {
+        std::cerr << "Imagem inválida para " << filename << std::endl;
+        return false;
+    }
+    
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao criar arquivo: " << filename << std::endl;
+        return false;
+    }
+    
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+    
+    std::vector<uint8_t> header;
+    appendBigEndian(header, static_cast<uint32_t>(width));
+    appendBigEndian(header, static_cast<uint32_t>(height));
+    header.push_back(8);  // bits por canal
+    header.push_back(2);  // RGB: o alfa do framebuffer é sempre opaco
+    header.push_back(0);
+    header.push_back(0);
+    header.push_back(0);
+    writeChunk(file, "IHDR", header);
+    
+    // Linhas RGB, cada uma com o filtro escolhido no primeiro byte
+    size_t rgbRowBytes = static_cast<size_t>(width) * 3;
+    std::vector<uint8_t> row(rgbRowBytes), previousRow(rgbRowBytes), candidate;
+    std::vector<uint8_t> filtered;
+    filtered.reserve((rgbRowBytes + 1) * height);
+    for (int y = 0; y < height; y++) {
+        const uint8_t* source = rgba.data() + y * rowBytes;
+        for (int x = 0; x < width; x++) {
+            row[x * 3 + 0] = source[x * 4 + 0];
+            row[x * 3 + 1] = source[x * 4 + 1];
+            row[x * 3 + 2] = source[x * 4 + 2];
+        }
+        filterRow(row.data(), y > 0 ? previousRow.data() : nullptr, rgbRowBytes, 3, candidate, filtered);
+        row.swap(previousRow);
+    }
+    
+    // Fluxo zlib: deflate com códigos fixos, ou blocos sem compressão se
+    // isso não reduzir o tamanho; Adler-32 no final
+    std::vector<uint8_t> compressed;
+    compressed.reserve(filtered.size() / 4 + 64);
+    compressed.push_back(0x78);
+    compressed.push_back(0x01);
+    deflateFixed(filtered, compressed);
+    if (compressed.size() > filtered.size() + filtered.size() / 65535 * 5 + 7) {
+        compressed.resize(2);
+        deflateStored(filtered, compressed);
+    }
+    appendBigEndian(compressed, adler32(filtered));
+    
+    writeChunk(file, "IDAT", compressed);
+    writeChunk(file, "IEND", {});
+    
+    return file.good();
+}
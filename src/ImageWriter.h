@@ -0,0 +1,14 @@
+#ifndef IMAGEWRITER_H
+#define IMAGEWRITER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Grava uma imagem RGBA 8 bits (linhas de cima para baixo) como PNG RGB;
+// o alfa é descartado. Cada linha recebe o filtro do PNG que melhor a
+// prevê, e a compressão é um deflate próprio com códigos de Huffman fixos,
+// dispensando zlib.
+bool writePNG(const std::string& filename, int width, int height, const std::vector<uint8_t>& rgba);
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef LRUCACHE_H
+#define LRUCACHE_H
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <cstddef>
+
+struct CacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t entries = 0;
+    size_t usedBytes = 0;
+    size_t budget = 0;
+};
+
+// Cache com orçamento de memória e descarte do item usado há mais tempo.
+// O tamanho de cada valor é informado na inserção. Não é sincronizado: quem
+// compartilha o cache entre threads o protege com seu próprio mutex.
+template <typename Value>
+class LRUCache {
+public:
+    explicit LRUCache(size_t budgetBytes = 0) : budget(budgetBytes) {}
+    
+    void setBudget(size_t budgetBytes) {
+        budget = budgetBytes;
+        evict();
+    }
+    
+    // Procura a chave contando acerto ou falha; o item encontrado passa a ser o mais recente
+    Value* find(const std::string& key) {
+        auto found = index.find(key);
+        if (found == index.end()) {
+            misses++;
+            return nullptr;
+        }
+        hits++;
+        entries.splice(entries.begin(), entries, found->second);
+        return &found->second->value;
+    }
+    
+    // Consulta sem alterar contadores nem a ordem de uso
+    bool contains(const std::string& key) const {
+        return index.count(key) > 0;
+    }
+    
+    // O item inserido nunca é descartado na mesma chamada, mesmo acima do orçamento
+    void insert(const std::string& key, Value value, size_t bytes) {
+        erase(key);
+        entries.push_front({key, std::move(value), bytes});
+        index[key] = entries.begin();
+        usedBytes += bytes;
+        evict();
+    }
+    
+    void erase(const std::string& key) {
+        auto found = index.find(key);
+        if (found == index.end()) return;
+        usedBytes -= found->second->bytes;
+        entries.erase(found->second);
+        index.erase(found);
+    }
+    
+    void clear() {
+        entries.clear();
+        index.clear();
+        usedBytes = 0;
+    }
+    
+    CacheStats getStats() const {
+        CacheStats stats;
+        stats.hits = hits;
+        stats.misses = misses;
+        stats.evictions = evictions;
+        stats.entries = entries.size();
+        stats.usedBytes = usedBytes;
+        stats.budget = budget;
+        return stats;
+    }
+    
+    size_t size() const { return entries.size(); }
+
+private:
+    struct Entry {
+        std::string key;
+        Value value;
+        size_t bytes;
+    };
+    
+    void evict() {
+        while (usedBytes > budget && entries.size() > 1) {
+            Entry& last = entries.back();
+            usedBytes -= last.bytes;
+            index.erase(last.key);
+            entries.pop_back();
+            evictions++;
+        }
+    }
+    
+    std::list<Entry> entries;      // do mais recente para o mais antigo
+    std::unordered_map<std::string, typename std::list<Entry>::iterator> index;
+    size_t budget;
+    size_t usedBytes = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+};
+
+#endif
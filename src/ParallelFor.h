@@ -0,0 +1,29 @@
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstddef>
+
+// Executa task(0..taskCount-1) distribuindo os índices entre as threads
+template <typename Task>
+void parallelFor(unsigned int threadCount, size_t taskCount, Task task) {
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < taskCount; i = next++) {
+            task(i);
+        }
+    };
+    
+    std::vector<std::thread> workers;
+    for (unsigned int t = 1; t < threadCount && t < taskCount; t++) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+}
+
+#endif
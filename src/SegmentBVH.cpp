@@ -0,0 +1,107 @@
+#include "SegmentBVH.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+const BoundingBox emptyBox = {
+    std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+    std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()
+};
+
+void expand(BoundingBox& box, const BoundingBox& other) {
+    box.minX = std::min(box.minX, other.minX);
+    box.minY = std::min(box.minY, other.minY);
+    box.maxX = std::max(box.maxX, other.maxX);
+    box.maxY = std::max(box.maxY, other.maxY);
+}
+
+bool intersects(const BoundingBox& a, const BoundingBox& b) {
+    return a.minX <= b.maxX && b.minX <= a.maxX && a.minY <= b.maxY && b.minY <= a.maxY;
+}
+
+bool contains(const BoundingBox& outer, const BoundingBox& inner) {
+    return inner.minX >= outer.minX && inner.maxX <= outer.maxX &&
+           inner.minY >= outer.minY && inner.maxY <= outer.maxY;
+}
+
+} // namespace
+
+void SegmentBVH::clear() {
+    nodes.clear();
+    nodeRanges.clear();
+    leafStart = 0;
+    segmentCount = 0;
+}
+
+void SegmentBVH::build(const std::vector<float>& vertices, const std::vector<float>& radii, float radiusScale) {
+    clear();
+    
+    // Os trechos são int: modelos maiores já são recusados em setTree
+    if (vertices.size() / 4 > static_cast<size_t>(std::numeric_limits<int>::max())) return;
+    segmentCount = static_cast<int>(vertices.size() / 4);
+    if (segmentCount == 0) return;
+    
+    int leafCount = (segmentCount + leafSize - 1) / leafSize;
+    leafStart = 1;
+    while (leafStart < leafCount) leafStart *= 2;
+    
+    nodes.assign(leafStart * 2, emptyBox);
+    nodeRanges.assign(leafStart * 2, DrawRange{0, 0});
+    
+    // Folhas: união das caixas dos segmentos do bloco, com o raio do vaso
+    for (int leaf = 0; leaf < leafCount; leaf++) {
+        int begin = leaf * leafSize;
+        int end = std::min(begin + leafSize, segmentCount);
+        BoundingBox& box = nodes[leafStart + leaf];
+        
+        for (int i = begin; i < end; i++) {
+            size_t s = static_cast<size_t>(i);
+            const float* v = &vertices[s * 4];
+            float r = std::max(radii[s * 2], radii[s * 2 + 1]) * radiusScale;
+            expand(box, {std::min(v[0], v[2]) - r, std::min(v[1], v[3]) - r,
+                         std::max(v[0], v[2]) + r, std::max(v[1], v[3]) + r});
+        }
+        nodeRanges[leafStart + leaf] = {begin, end};
+    }
+    for (int leaf = leafCount; leaf < leafStart; leaf++) {
+        nodeRanges[leafStart + leaf] = {segmentCount, segmentCount};
+    }
+    
+    // Nós internos de baixo para cima
+    for (int k = leafStart - 1; k >= 1; k--) {
+        nodes[k] = nodes[2 * k];
+        expand(nodes[k], nodes[2 * k + 1]);
+        nodeRanges[k] = {nodeRanges[2 * k].begin, nodeRanges[2 * k + 1].end};
+    }
+}
+
+void SegmentBVH::query(const BoundingBox& region, std::vector<DrawRange>& ranges) const {
+    ranges.clear();
+    if (segmentCount == 0) return;
+    
+    // Filho da esquerda primeiro: os trechos saem em ordem crescente
+    std::vector<int> stack = {1};
+    while (!stack.empty()) {
+        int k = stack.back();
+        stack.pop_back();
+        
+        const BoundingBox& box = nodes[k];
+        if (!intersects(box, region)) continue;
+        
+        if (k >= leafStart || contains(region, box)) {
+            const DrawRange& range = nodeRanges[k];
+            if (range.begin == range.end) continue;
+            
+            if (!ranges.empty() && ranges.back().end == range.begin) {
+                ranges.back().end = range.end;
+            } else {
+                ranges.push_back(range);
+            }
+            continue;
+        }
+        
+        stack.push_back(2 * k + 1);
+        stack.push_back(2 * k);
+    }
+}
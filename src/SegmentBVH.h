@@ -0,0 +1,32 @@
+#ifndef SEGMENTBVH_H
+#define SEGMENTBVH_H
+
+#include "TreeLOD.h"
+#include <vector>
+
+// Hierarquia de caixas envolventes sobre os segmentos na ordem em que estão
+// nos buffers (pré-ordem, espacialmente coerente). Cada folha cobre um bloco
+// contíguo de segmentos, então a consulta devolve trechos contíguos.
+class SegmentBVH {
+public:
+    static const int leafSize = 64;
+    
+    // vertices: (x0, y0, x1, y1) por segmento; radii: (inicial, final), que
+    // aumentam as caixas para os vasos
+    void build(const std::vector<float>& vertices, const std::vector<float>& radii, float radiusScale);
+    void clear();
+    
+    // Trechos de segmentos cujas caixas intersectam a região, em ordem crescente
+    void query(const BoundingBox& region, std::vector<DrawRange>& ranges) const;
+    
+    bool empty() const { return segmentCount == 0; }
+    
+private:
+    // Árvore binária implícita: filhos de k em 2k e 2k + 1, folhas a partir de leafStart
+    std::vector<BoundingBox> nodes;
+    std::vector<DrawRange> nodeRanges;
+    int leafStart = 0;
+    int segmentCount = 0;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#include "SegmentTable.h"
+
+template <typename Real, typename Index>
+void BasicSegmentTable<Real, Index>::resize(size_t count) {
+    for (auto& values : reals) values.resize(count);
+    parents.resize(count, -1);
+}
+
+template <typename Real, typename Index>
+void BasicSegmentTable<Real, Index>::reserve(size_t count) {
+    for (auto& values : reals) values.reserve(count);
+    parents.reserve(count);
+}
+
+template <typename Real, typename Index>
+void BasicSegmentTable<Real, Index>::clear() {
+    for (auto& values : reals) values.clear();
+    parents.clear();
+}
+
+template <typename Real, typename Index>
+void BasicSegmentTable<Real, Index>::push_back(const Segment& segment) {
+    reals[x0].push_back(segment.start.x);
+    reals[y0].push_back(segment.start.y);
+    reals[x1].push_back(segment.end.x);
+    reals[y1].push_back(segment.end.y);
+    reals[r0].push_back(segment.startRadius);
+    reals[r1].push_back(segment.endRadius);
+    parents.push_back(segment.parentIndex);
+}
+
+template <typename Real, typename Index>
+void BasicSegmentTable<Real, Index>::set(size_t i, const Segment& segment) {
+    reals[x0][i] = segment.start.x;
+    reals[y0][i] = segment.start.y;
+    reals[x1][i] = segment.end.x;
+    reals[y1][i] = segment.end.y;
+    reals[r0][i] = segment.startRadius;
+    reals[r1][i] = segment.endRadius;
+    parents[i] = segment.parentIndex;
+}
+
+template <typename Real, typename Index>
+BasicSegment<Real, Index> BasicSegmentTable<Real, Index>::operator[](size_t i) const {
+    return Segment(BasicPoint2D<Real>(reals[x0][i], reals[y0][i]), BasicPoint2D<Real>(reals[x1][i], reals[y1][i]),
+                   reals[r0][i], reals[r1][i], parents[i]);
+}
+
+template <typename Real, typename Index>
+void BasicSegmentTable<Real, Index>::normalizePositions(Real centerX, Real centerY, Real scale) {
+    // Um laço simples por coluna, sem dependências entre iterações: o
+    // compilador o vetoriza
+    size_t n = size();
+    for (RealColumn c : {x0, x1, y0, y1}) {
+        Real center = (c == x0 || c == x1) ? centerX : centerY;
+        Real* __restrict values = reals[c].data();
+        for (size_t i = 0; i < n; i++) {
+            values[i] = (values[i] - center) * scale;
+        }
+    }
+}
+
+template <typename Real, typename Index>
+size_t BasicSegmentTable<Real, Index>::memoryUsage() const {
+    size_t bytes = parents.capacity() * sizeof(Index);
+    for (const auto& values : reals) bytes += values.capacity() * sizeof(Real);
+    return bytes;
+}
+
+#define INSTANTIATE_SEGMENT_TABLE(Real, Index) template class BasicSegmentTable<Real, Index>;
+TREE_MODEL_TYPES(INSTANTIATE_SEGMENT_TABLE)
+#undef INSTANTIATE_SEGMENT_TABLE
@@ -0,0 +1,131 @@
+#ifndef SEGMENTTABLE_H
+#define SEGMENTTABLE_H
+
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+
+// O modelo da árvore é parametrizado pela precisão das coordenadas (Real) e
+// pela largura dos índices de pontos e segmentos (Index). Cada arquivo que
+// implementa um template do modelo o instancia para todas as combinações:
+#define TREE_MODEL_TYPES(X) \
+    X(float, int16_t) X(float, int32_t) X(float, int64_t) \
+    X(double, int16_t) X(double, int32_t) X(double, int64_t)
+
+template <typename Real>
+struct BasicPoint2D {
+    Real x, y;
+    BasicPoint2D(Real x = Real(0), Real y = Real(0)) : x(x), y(y) {}
+};
+
+template <typename Real, typename Index>
+struct BasicSegment {
+    BasicPoint2D<Real> start, end;
+    Real startRadius, endRadius;
+    Index parentIndex;
+    
+    BasicSegment(BasicPoint2D<Real> s = BasicPoint2D<Real>(), BasicPoint2D<Real> e = BasicPoint2D<Real>(),
+                 Real sr = Real(0.1f), Real er = Real(0.05f), Index parent = -1)
+        : start(s), end(e), startRadius(sr), endRadius(er), parentIndex(parent) {}
+};
+
+// Trecho contíguo de um array, sem posse dos dados (o std::span do C++20)
+template <typename T>
+class Span {
+public:
+    Span() : ptr(nullptr), count(0) {}
+    Span(T* data, size_t size) : ptr(data), count(size) {}
+    
+    T* data() const { return ptr; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T& operator[](size_t i) const { return ptr[i]; }
+    T* begin() const { return ptr; }
+    T* end() const { return ptr + count; }
+
+private:
+    T* ptr;
+    size_t count;
+};
+
+// Alocador com blocos alinhados a 64 bytes: cada coluna começa em uma linha
+// de cache e os laços sobre ela podem usar leituras vetoriais alinhadas
+template <typename T>
+struct AlignedAllocator {
+    using value_type = T;
+    static constexpr std::align_val_t alignment{64};
+    
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+    
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), alignment)); }
+    void deallocate(T* p, size_t) { ::operator delete(p, alignment); }
+    
+    template <typename U>
+    bool operator==(const AlignedAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U>&) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// Segmentos da árvore em colunas (SoA): coordenadas do início e do fim, raios
+// e pai, cada um em seu próprio array alinhado. Os laços que só precisam de
+// parte dos campos leem apenas as colunas correspondentes, e cada coluna pode
+// ser copiada inteira para um buffer.
+template <typename Real, typename Index>
+class BasicSegmentTable {
+public:
+    using Segment = BasicSegment<Real, Index>;
+    
+    size_t size() const { return parents.size(); }
+    bool empty() const { return parents.empty(); }
+    
+    void resize(size_t count);
+    void reserve(size_t count);
+    void clear();
+    
+    void push_back(const Segment& segment);
+    void set(size_t i, const Segment& segment);
+    Segment operator[](size_t i) const;     // cópia montada a partir das colunas
+    
+    Span<Real> startX() { return column(x0); }
+    Span<Real> startY() { return column(y0); }
+    Span<Real> endX() { return column(x1); }
+    Span<Real> endY() { return column(y1); }
+    Span<Real> startRadius() { return column(r0); }
+    Span<Real> endRadius() { return column(r1); }
+    Span<Index> parentIndex() { return Span<Index>(parents.data(), parents.size()); }
+    
+    Span<const Real> startX() const { return column(x0); }
+    Span<const Real> startY() const { return column(y0); }
+    Span<const Real> endX() const { return column(x1); }
+    Span<const Real> endY() const { return column(y1); }
+    Span<const Real> startRadius() const { return column(r0); }
+    Span<const Real> endRadius() const { return column(r1); }
+    Span<const Index> parentIndex() const { return Span<const Index>(parents.data(), parents.size()); }
+    
+    // Coordenadas = (coordenada - centro) * escala, nas quatro colunas
+    void normalizePositions(Real centerX, Real centerY, Real scale);
+    
+    size_t memoryUsage() const;
+
+private:
+    enum RealColumn { x0, y0, x1, y1, r0, r1, realColumnCount };
+    
+    Span<Real> column(RealColumn c) { return Span<Real>(reals[c].data(), reals[c].size()); }
+    Span<const Real> column(RealColumn c) const { return Span<const Real>(reals[c].data(), reals[c].size()); }
+    
+    AlignedVector<Real> reals[realColumnCount];
+    AlignedVector<Index> parents;
+};
+
+// Modelo padrão, usado pela árvore de teste dos renderizadores
+using Point2D = BasicPoint2D<float>;
+using Segment = BasicSegment<float, int32_t>;
+using SegmentTable = BasicSegmentTable<float, int32_t>;
+
+#endif
@@ -0,0 +1,97 @@
+#include "SpatialHash.h"
+#include <cmath>
+
+template <typename Real>
+void SpatialHashGrid<Real>::clear() {
+    x = Span<const Real>();
+    y = Span<const Real>();
+    bucketOffsets.clear();
+    entries.clear();
+    bucketMask = 0;
+}
+
+template <typename Real>
+void SpatialHashGrid<Real>::build(Span<const Real> xs, Span<const Real> ys, Real maxDistance) {
+    clear();
+    x = xs;
+    y = ys;
+    tolerance = maxDistance;
+    
+    // Células um pouco maiores que a tolerância: arredondamentos na divisão
+    // não levam dois pontos próximos a células que não são vizinhas
+    inverseCellSize = Real(1) / (tolerance * Real(1.001));
+    
+    // Duas vezes mais baldes que pontos, em potência de 2
+    size_t bucketCount = 1;
+    while (bucketCount < x.size() * 2) bucketCount *= 2;
+    bucketMask = bucketCount - 1;
+    
+    // Contagem por balde + prefixo, como as listas de filhos da topologia
+    std::vector<size_t> bucket(x.size());
+    bucketOffsets.assign(bucketCount + 1, 0);
+    for (size_t i = 0; i < x.size(); i++) {
+        bucket[i] = bucketOf(cellOf(x[i]), cellOf(y[i]));
+        bucketOffsets[bucket[i] + 1]++;
+    }
+    for (size_t b = 0; b < bucketCount; b++) {
+        bucketOffsets[b + 1] += bucketOffsets[b];
+    }
+    
+    entries.resize(x.size());
+    std::vector<size_t> fill(bucketOffsets.begin(), bucketOffsets.end() - 1);
+    for (size_t i = 0; i < x.size(); i++) {
+        entries[fill[bucket[i]]++] = i;
+    }
+}
+
+template <typename Real>
+int64_t SpatialHashGrid<Real>::findFirst(Real px, Real py, int64_t exclude) const {
+    if (entries.empty()) return -1;
+    
+    int64_t cellX = cellOf(px), cellY = cellOf(py);
+    int64_t best = -1;
+    for (int64_t dx = -1; dx <= 1; dx++) {
+        for (int64_t dy = -1; dy <= 1; dy++) {
+            // Baldes podem misturar células diferentes: a distância decide
+            size_t b = bucketOf(cellX + dx, cellY + dy);
+            for (size_t e = bucketOffsets[b]; e < bucketOffsets[b + 1]; e++) {
+                int64_t j = static_cast<int64_t>(entries[e]);
+                if (best >= 0 && j >= best) break;
+                if (j == exclude) continue;
+                
+                Real dist = std::abs(x[entries[e]] - px) + std::abs(y[entries[e]] - py);
+                if (dist < tolerance) {
+                    best = j;
+                    break;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+template <typename Real>
+int64_t SpatialHashGrid<Real>::findEqual(Real px, Real py) const {
+    if (entries.empty()) return -1;
+    
+    size_t b = bucketOf(cellOf(px), cellOf(py));
+    for (size_t e = bucketOffsets[b]; e < bucketOffsets[b + 1]; e++) {
+        if (x[entries[e]] == px && y[entries[e]] == py) return static_cast<int64_t>(entries[e]);
+    }
+    return -1;
+}
+
+template <typename Real>
+int64_t SpatialHashGrid<Real>::cellOf(Real value) const {
+    return static_cast<int64_t>(std::floor(value * inverseCellSize));
+}
+
+template <typename Real>
+size_t SpatialHashGrid<Real>::bucketOf(int64_t cellX, int64_t cellY) const {
+    uint64_t h = static_cast<uint64_t>(cellX) * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(cellY) * 0xC2B2AE3D27D4EB4Full;
+    h ^= h >> 29;
+    return static_cast<size_t>(h & bucketMask);
+}
+
+template class SpatialHashGrid<float>;
+template class SpatialHashGrid<double>;
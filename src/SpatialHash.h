@@ -0,0 +1,44 @@
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+
+#include "SegmentTable.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Grade uniforme com hash sobre um conjunto de pontos, para achar pontos
+// próximos ou coincidentes em tempo constante esperado. As células têm o
+// lado de tolerance: findFirst examina a célula do ponto consultado e as
+// oito vizinhas, e findEqual só a célula do ponto, onde um ponto igual
+// necessariamente está. As coordenadas não são copiadas: devem continuar
+// válidas enquanto a grade for usada.
+template <typename Real>
+class SpatialHashGrid {
+public:
+    void build(Span<const Real> x, Span<const Real> y, Real tolerance);
+    void clear();
+    
+    // Menor índice j != exclude com |x[j] - px| + |y[j] - py| < tolerance, ou
+    // -1 se não houver; pode ser chamada de várias threads ao mesmo tempo
+    int64_t findFirst(Real px, Real py, int64_t exclude) const;
+    // Menor índice j com x[j] == px e y[j] == py, ou -1; só a célula do
+    // ponto consultado é examinada
+    int64_t findEqual(Real px, Real py) const;
+    
+    size_t size() const { return x.size(); }
+
+private:
+    Span<const Real> x, y;
+    Real tolerance = Real(0);
+    Real inverseCellSize = Real(0);
+    uint64_t bucketMask = 0;
+    
+    // Pontos de cada balde em ordem crescente: entries[bucketOffsets[b] .. bucketOffsets[b + 1])
+    std::vector<size_t> bucketOffsets;
+    std::vector<size_t> entries;
+    
+    int64_t cellOf(Real value) const;
+    size_t bucketOf(int64_t cellX, int64_t cellY) const;
+};
+
+#endif
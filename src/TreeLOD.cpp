@@ -0,0 +1,85 @@
+#include "TreeLOD.h"
+#include <algorithm>
+
+void TreeLOD::clear() {
+    subtreeBounds.clear();
+    subtreeEnd.clear();
+    chainOffsets.clear();
+}
+
+void TreeLOD::build(const std::vector<float>& vertices, const std::vector<int>& subtreeSize,
+                    const std::vector<int>& chainOffsets) {
+    clear();
+    this->chainOffsets = chainOffsets;
+    
+    const int n = static_cast<int>(subtreeSize.size());
+    subtreeBounds.resize(n);
+    subtreeEnd.resize(n);
+    
+    for (int i = 0; i < n; i++) {
+        const float* v = &vertices[static_cast<size_t>(i) * 4];
+        subtreeBounds[i] = {std::min(v[0], v[2]), std::min(v[1], v[3]),
+                            std::max(v[0], v[2]), std::max(v[1], v[3])};
+        subtreeEnd[i] = i + subtreeSize[i];
+    }
+    
+    // Na pré-ordem os filhos vêm depois do pai: percorrendo de trás para a
+    // frente, cada subárvore já está completa quando chega a vez do seu pai.
+    // O pai de i é o último segmento antes de i cuja subárvore contém i.
+    std::vector<int> open;
+    std::vector<int> parentInOrder(n, -1);
+    for (int i = 0; i < n; i++) {
+        while (!open.empty() && subtreeEnd[open.back()] <= i) open.pop_back();
+        if (!open.empty()) parentInOrder[i] = open.back();
+        open.push_back(i);
+    }
+    
+    for (int i = n - 1; i >= 0; i--) {
+        int p = parentInOrder[i];
+        if (p == -1) continue;
+        
+        BoundingBox& parentBox = subtreeBounds[p];
+        const BoundingBox& box = subtreeBounds[i];
+        parentBox.minX = std::min(parentBox.minX, box.minX);
+        parentBox.minY = std::min(parentBox.minY, box.minY);
+        parentBox.maxX = std::max(parentBox.maxX, box.maxX);
+        parentBox.maxY = std::max(parentBox.maxY, box.maxY);
+    }
+}
+
+void TreeLOD::selectCut(float pixelsPerUnit, float minPixels, std::vector<DrawRange>& ranges) const {
+    ranges.clear();
+    
+    const int n = static_cast<int>(subtreeEnd.size());
+    const float minExtent = (pixelsPerUnit > 0.0f) ? minPixels / pixelsPerUnit : 0.0f;
+    
+    int i = 0;
+    while (i < n) {
+        // Ao longo de uma cadeia cada subárvore contém a seguinte, então as
+        // extensões só diminuem: os segmentos acima do limite formam um
+        // prefixo, e o primeiro abaixo dele é o último desenhado
+        int chainEnd = *std::upper_bound(chainOffsets.begin(), chainOffsets.end(), i);
+        int low = i, high = chainEnd;
+        while (low < high) {
+            int middle = low + (high - low) / 2;
+            if (subtreeBounds[middle].extent() < minExtent) high = middle;
+            else low = middle + 1;
+        }
+        
+        // Todo segmento visitado é desenhado; trechos consecutivos são unidos
+        int end = std::min(low + 1, chainEnd);
+        if (!ranges.empty() && ranges.back().end == i) {
+            ranges.back().end = end;
+        } else {
+            ranges.push_back({i, end});
+        }
+        
+        // Subárvore abaixo de um pixel: pula todos os descendentes
+        i = (low < chainEnd) ? subtreeEnd[low] : chainEnd;
+    }
+}
+
+size_t TreeLOD::memoryUsage() const {
+    return subtreeBounds.capacity() * sizeof(BoundingBox) +
+           (subtreeEnd.capacity() + chainOffsets.capacity()) * sizeof(int);
+}
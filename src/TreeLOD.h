@@ -0,0 +1,45 @@
+#ifndef TREELOD_H
+#define TREELOD_H
+
+#include <vector>
+#include <cstddef>
+
+struct BoundingBox {
+    float minX, minY, maxX, maxY;
+    
+    float extent() const { return (maxX - minX > maxY - minY) ? maxX - minX : maxY - minY; }
+};
+
+// Trecho contíguo [begin, end) de segmentos na pré-ordem
+struct DrawRange {
+    int begin, end;
+};
+
+// Hierarquia de nível de detalhe sobre as subárvores: com os segmentos em
+// pré-ordem, cada subárvore é um trecho contíguo e pode ser descartada inteira
+class TreeLOD {
+public:
+    // vertices: (x0, y0, x1, y1) por segmento; subtreeSize: segmentos de cada
+    // subárvore; chainOffsets: início de cada cadeia de filhos únicos e o
+    // total no fim (ver BasicTreeTopology::chainOffsets), todos na pré-ordem
+    void build(const std::vector<float>& vertices, const std::vector<int>& subtreeSize,
+               const std::vector<int>& chainOffsets);
+    void clear();
+    
+    // Escolhe o corte da hierarquia: subárvores menores que minPixels na tela
+    // são representadas apenas pelo seu segmento raiz. Cada cadeia é
+    // resolvida por busca binária, com custo proporcional ao número de
+    // cadeias selecionadas.
+    void selectCut(float pixelsPerUnit, float minPixels, std::vector<DrawRange>& ranges) const;
+    
+    size_t size() const { return subtreeEnd.size(); }
+    size_t memoryUsage() const;
+    const BoundingBox& getSubtreeBounds(int segment) const { return subtreeBounds[segment]; }
+    
+private:
+    std::vector<BoundingBox> subtreeBounds;
+    std::vector<int> subtreeEnd;
+    std::vector<int> chainOffsets;
+};
+
+#endif
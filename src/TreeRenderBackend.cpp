@@ -0,0 +1,149 @@
+#include "TreeRenderBackend.h"
+#include <iostream>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// Raio máximo aceito como estando na mesma unidade das coordenadas
+// normalizadas, e o raio para o qual raios maiores são reescalados
+const float maxPlausibleRadius = 0.1f;
+const float fittedMaxRadius = 0.02f;
+
+} // namespace
+
+TreeRenderBackend::TreeRenderBackend()
+    : transform{1.0f, 0.0f, 0.0f, 0.0f,
+                0.0f, 1.0f, 0.0f, 0.0f,
+                0.0f, 0.0f, 1.0f, 0.0f,
+                0.0f, 0.0f, 0.0f, 1.0f},
+      lineWidth(2.0f),
+      useMonochrome(false), gradientMode(false),
+      thicknessMode(false), descendantsColorMode(false),
+      vesselMode(false) {}
+
+void TreeRenderBackend::applyTransform(const float* transformMatrix) {
+    std::copy(transformMatrix, transformMatrix + 16, transform);
+}
+
+template <typename Real, typename Index>
+void TreeRenderBackend::setTree(const BasicSegmentTable<Real, Index>& segments,
+                                const BasicTreeTopology<Index>& topology) {
+    SegmentData data;
+    if (segments.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        // Os trechos de desenho e as contagens do OpenGL são int
+        std::cout << "[!] Árvore com " << segments.size() << " segmentos: acima do limite de "
+                  << std::numeric_limits<int>::max() << " dos renderizadores" << std::endl;
+    } else if (segments.empty()) {
+        std::cout << "Nenhuma árvore carregada, renderizando árvore de teste..." << std::endl;
+        SegmentTable testSegments = createTestTree();
+        TreeTopology testTopology;
+        testTopology.build(testSegments);
+        collectSegmentData(testSegments, testTopology, data);
+    } else {
+        collectSegmentData(segments, topology, data);
+    }
+    
+    prepareTree(std::move(data));
+}
+
+int TreeRenderBackend::colorMode() const {
+    if (useMonochrome) return 1;
+    if (gradientMode) return 2;
+    if (descendantsColorMode) return 3;
+    return 0;
+}
+
+template <typename Real, typename Index>
+bool TreeRenderBackend::collectSegmentData(const BasicSegmentTable<Real, Index>& segments,
+                                           const BasicTreeTopology<Index>& topology, SegmentData& data) {
+    data = SegmentData();
+    
+    if (segments.empty() || topology.size() != segments.size()) return false;
+    
+    data.segmentCount = segments.size();
+    
+    // Valores máximos para normalização
+    float maxDepth = topology.maxDepth > 0 ? static_cast<float>(topology.maxDepth) : 1.0f;
+    float maxDescendants = topology.maxDescendants > 0 ? static_cast<float>(topology.maxDescendants) : 1.0f;
+    
+    // Cada coluna é lida na pré-ordem e convertida para float, a precisão dos
+    // renderizadores; as métricas vêm só da topologia
+    size_t n = segments.size();
+    data.vertices.resize(n * 4);
+    data.normalizedDepth.resize(n);
+    data.normalizedDescendants.resize(n);
+    data.radii.resize(n * 2);
+    data.subtreeSize.resize(n);
+    data.parentOrder.resize(n);
+    
+    Span<const Real> startX = segments.startX(), startY = segments.startY();
+    Span<const Real> endX = segments.endX(), endY = segments.endY();
+    Span<const Real> startRadius = segments.startRadius(), endRadius = segments.endRadius();
+    const Index* order = topology.preorder.data();
+    for (size_t k = 0; k < n; k++) {
+        Index i = order[k];
+        float* v = &data.vertices[k * 4];
+        v[0] = static_cast<float>(startX[i]);
+        v[1] = static_cast<float>(startY[i]);
+        v[2] = static_cast<float>(endX[i]);
+        v[3] = static_cast<float>(endY[i]);
+        data.radii[k * 2] = static_cast<float>(startRadius[i]);
+        data.radii[k * 2 + 1] = static_cast<float>(endRadius[i]);
+    }
+    
+    // Posição de cada segmento na pré-ordem, para levar os pais à mesma ordem
+    std::vector<int> position(n);
+    for (size_t k = 0; k < n; k++) position[order[k]] = static_cast<int>(k);
+    
+    for (size_t k = 0; k < n; k++) {
+        Index i = order[k];
+        data.normalizedDepth[k] = static_cast<float>(topology.depth[i]) / maxDepth;
+        data.normalizedDescendants[k] = static_cast<float>(topology.descendantCount[i]) / maxDescendants;
+        data.subtreeSize[k] = static_cast<int>(topology.descendantCount[i] + 1);
+        data.parentOrder[k] = topology.parent[i] >= 0 ? position[topology.parent[i]] : -1;
+    }
+    
+    data.chainOffsets.assign(topology.chainOffsets.begin(), topology.chainOffsets.end());
+    
+    float maxRadius = 0.0f;
+    for (size_t k = 0; k < n; k++) {
+        maxRadius = std::max(maxRadius, std::max(data.radii[k * 2], data.radii[k * 2 + 1]));
+    }
+    
+    // Raios gravados em outra unidade que a das coordenadas (ex.: mm contra m
+    // nos arquivos de exemplo) ficariam maiores que a própria árvore
+    data.radiusScale = 1.0f;
+    if (maxRadius > maxPlausibleRadius) {
+        data.radiusScale = fittedMaxRadius / maxRadius;
+    }
+    return true;
+}
+
+SegmentTable TreeRenderBackend::createTestTree() {
+    SegmentTable testSegments;
+    
+    // Tronco principal
+    testSegments.push_back(Segment(Point2D(0.0f, -1.0f), Point2D(0.0f, -0.5f), 0.1f, 0.08f, -1));
+    
+    // Ramos primários
+    testSegments.push_back(Segment(Point2D(0.0f, -0.5f), Point2D(0.3f, -0.2f), 0.08f, 0.06f, 0));
+    testSegments.push_back(Segment(Point2D(0.0f, -0.5f), Point2D(-0.3f, -0.2f), 0.08f, 0.06f, 0));
+    
+    // Ramos secundários
+    testSegments.push_back(Segment(Point2D(0.3f, -0.2f), Point2D(0.5f, 0.1f), 0.06f, 0.04f, 1));
+    testSegments.push_back(Segment(Point2D(-0.3f, -0.2f), Point2D(-0.5f, 0.1f), 0.06f, 0.04f, 2));
+    
+    // Ramos terciários
+    testSegments.push_back(Segment(Point2D(0.5f, 0.1f), Point2D(0.6f, 0.4f), 0.04f, 0.02f, 3));
+    testSegments.push_back(Segment(Point2D(0.5f, 0.1f), Point2D(0.4f, 0.4f), 0.04f, 0.02f, 3));
+    testSegments.push_back(Segment(Point2D(-0.5f, 0.1f), Point2D(-0.6f, 0.4f), 0.04f, 0.02f, 4));
+    testSegments.push_back(Segment(Point2D(-0.5f, 0.1f), Point2D(-0.4f, 0.4f), 0.04f, 0.02f, 4));
+    
+    return testSegments;
+}
+
+#define INSTANTIATE_BACKEND_TREE(Real, Index) \
+    template void TreeRenderBackend::setTree(const BasicSegmentTable<Real, Index>&, const BasicTreeTopology<Index>&);
+TREE_MODEL_TYPES(INSTANTIATE_BACKEND_TREE)
+#undef INSTANTIATE_BACKEND_TREE
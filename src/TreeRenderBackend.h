@@ -0,0 +1,68 @@
+#ifndef TREERENDERBACKEND_H
+#define TREERENDERBACKEND_H
+
+#include "VTKLoader.h"
+#include "TreeTopology.h"
+#include <vector>
+
+// Interface comum aos renderizadores da árvore: OpenGL (TreeRenderer) e
+// rasterização em CPU (CpuTreeRenderer). Guarda a câmera e os modos de
+// visualização; cada implementação prepara e desenha os segmentos.
+class TreeRenderBackend {
+public:
+    TreeRenderBackend();
+    virtual ~TreeRenderBackend() = default;
+    
+    virtual bool initialize() = 0;
+    virtual void cleanup() = 0;
+    virtual void render() = 0;
+    virtual void applyTransform(const float* transformMatrix);
+    
+    // Aceita qualquer modelo de TREE_MODEL_TYPES; os dados são convertidos
+    // para float na preparação. Modelos com mais de INT_MAX segmentos são
+    // recusados e nada é desenhado.
+    template <typename Real, typename Index>
+    void setTree(const BasicSegmentTable<Real, Index>& segments, const BasicTreeTopology<Index>& topology);
+    void setLineWidth(float width) { lineWidth = width; }
+    void setColorMode(bool monochrome) { useMonochrome = monochrome; }
+    void setGradientMode(bool enabled) { gradientMode = enabled; }
+    void setThicknessMode(bool enabled) { thicknessMode = enabled; }
+    void setDescendantsColorMode(bool enabled) { descendantsColorMode = enabled; }
+    void setVesselMode(bool enabled) { vesselMode = enabled; }
+    
+protected:
+    // Atributos por segmento na pré-ordem da topologia, de modo que cada
+    // subárvore seja um trecho contíguo
+    struct SegmentData {
+        std::vector<float> vertices;              // (x, y) do início e do fim de cada segmento
+        std::vector<float> normalizedDepth;
+        std::vector<float> normalizedDescendants;
+        std::vector<float> radii;                 // raio inicial e final de cada segmento
+        std::vector<int> subtreeSize;             // o segmento e seus descendentes
+        std::vector<int> parentOrder;             // posição do pai na pré-ordem (-1 nas raízes)
+        std::vector<int> chainOffsets;            // cadeias de filhos únicos, da topologia
+        float radiusScale = 1.0f;
+        size_t segmentCount = 0;
+    };
+    
+    // Recebe os dados já coletados (segmentCount 0 se o modelo era inválido)
+    virtual void prepareTree(SegmentData&& data) = 0;
+    
+    template <typename Real, typename Index>
+    static bool collectSegmentData(const BasicSegmentTable<Real, Index>& segments,
+                                   const BasicTreeTopology<Index>& topology, SegmentData& data);
+    static SegmentTable createTestTree();
+    
+    // 0 branco, 1 verde, 2 profundidade, 3 descendentes
+    int colorMode() const;
+    
+    float transform[16];
+    float lineWidth;
+    bool useMonochrome;
+    bool gradientMode;
+    bool thicknessMode;
+    bool descendantsColorMode;
+    bool vesselMode;
+};
+
+#endif
@@ -1,341 +1,805 @@
 #include "TreeRenderer.h"
+#include "TreeTopology.h"
 #include "glad/glad.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <cmath>
 #include <algorithm>
-#include <queue>
-#include <unordered_map>
-#include <stack>
-#include <functional>
+#include <limits>
+#include <cstddef>
 
-TreeRenderer::TreeRenderer() : shaderProgram(0), VAO(0), VBO(0), lineWidth(2.0f), 
-                               useMonochrome(false), gradientMode(false), 
-                               thicknessMode(false), descendantsColorMode(false) {} // NOVO
+TreeRenderer::TreeRenderer() : shaderProgram(0), 
+                               wideProgram(0), capsuleProgram(0), quadVBO(0),
+                               cutQuadVAO(0), cutInstanceVBO(0),
+                               tree(std::make_shared<PreparedTree>()),
+                               treeCache(defaultCacheBudget), quantizationTileSize(0.0f) {}
 
 TreeRenderer::~TreeRenderer() {
-    if (VAO) glDeleteVertexArrays(1, &VAO);
-    if (VBO) glDeleteBuffers(1, &VBO);
+    cleanup();
+}
+
+void TreeRenderer::cleanup() {
+    // Os buffers de cada árvore são liberados junto com ela
+    tree = std::make_shared<PreparedTree>();
+    treeCache.clear();
+    
     if (shaderProgram) glDeleteProgram(shaderProgram);
+    if (quadVBO) glDeleteBuffers(1, &quadVBO);
+    if (cutQuadVAO) glDeleteVertexArrays(1, &cutQuadVAO);
+    if (cutInstanceVBO) glDeleteBuffers(1, &cutInstanceVBO);
+    if (wideProgram) glDeleteProgram(wideProgram);
+    if (capsuleProgram) glDeleteProgram(capsuleProgram);
+    
+    shaderProgram = quadVBO = 0;
+    cutQuadVAO = cutInstanceVBO = 0;
+    wideProgram = capsuleProgram = 0;
+}
+
+namespace {
+
+// Subárvores menores que isto na tela são desenhadas só pelo segmento raiz;
+// o corte é refeito quando a escala em pixels varia mais que a tolerância
+const float lodMinPixels = 1.0f;
+const float lodScaleTolerance = 0.1f;
+
+// Margem em pixels para segmentos largos na borda da tela, e folga da região
+// consultada na BVH (fração do tamanho da vista) para evitar nova consulta a
+// cada pequeno movimento da câmera
+const float viewMarginPixels = 16.0f;
+const float viewQueryPadding = 0.25f;
+
+// Índice que separa as faixas de linhas no buffer de índices
+const unsigned int lineRestartIndex = 0xFFFFFFFFu;
+
+// Vértice das faixas de linhas: posição relativa ao ladrilho e
+// (profundidade, descendentes) do segmento que termina nele
+struct LineVertex {
+    int16_t x, y;
+    uint16_t depth, descendants;
+};
+
+// Valores quantizados: posições em [-32767, 32767] a partir do centro do
+// ladrilho, e valores em [0, 1] em uint16 normalizado
+const float quantizedPositionMax = 32767.0f;
+
+int16_t quantizePosition(float value, float center, float scale) {
+    float q = std::round((value - center) / scale);
+    return static_cast<int16_t>(std::max(-quantizedPositionMax, std::min(quantizedPositionMax, q)));
 }
 
+uint16_t quantizeUnit(float value) {
+    return static_cast<uint16_t>(std::round(std::max(0.0f, std::min(1.0f, value)) * 65535.0f));
+}
+
+BoundingBox segmentBox(const float* v) {
+    return {std::min(v[0], v[2]), std::min(v[1], v[3]), std::max(v[0], v[2]), std::max(v[1], v[3])};
+}
+
+// Interseção de duas listas ordenadas de trechos
+void intersectRanges(const std::vector<DrawRange>& a, const std::vector<DrawRange>& b,
+                     std::vector<DrawRange>& result) {
+    result.clear();
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        int begin = std::max(a[i].begin, b[j].begin);
+        int end = std::min(a[i].end, b[j].end);
+        if (begin < end) result.push_back({begin, end});
+        
+        if (a[i].end < b[j].end) i++;
+        else j++;
+    }
+}
+
+// Cores e espessuras calculadas na GPU a partir da profundidade e do número
+// de descendentes normalizados; o modo é escolhido por uniforms
+const char* segmentStyleSource = R"(
+    uniform int colorMode;      // 0 branco, 1 verde, 2 profundidade, 3 descendentes
+    uniform bool thicknessMode;
+    uniform float lineWidth;
+    
+    vec3 segmentColor(float normalizedDepth, float normalizedDescendants) {
+        if (colorMode == 1) {
+            return vec3(0.0, 1.0, 0.0);
+        } else if (colorMode == 2) {
+            // Gradiente bottom-up: Violeta (folhas) -> Vermelho (raiz)
+            return vec3(1.0 - normalizedDepth * 0.5, 0.0, normalizedDepth * 0.5);
+        } else if (colorMode == 3) {
+            // Gradiente por número de descendentes
+            return vec3(sqrt(normalizedDescendants), 0.0,
+                        1.0 - normalizedDescendants * normalizedDescendants);
+        }
+        return vec3(1.0);
+    }
+    
+    float segmentThickness(float normalizedDescendants) {
+        // Espessura baseada no número de descendentes
+        float thickness = thicknessMode ? 2.0 + normalizedDescendants * 13.0 : lineWidth;
+        return clamp(thickness, 1.0, 10.0);
+    }
+)";
+
+// Posições chegam em int16 (convertidos para float sem normalizar) e são
+// levadas ao espaço da árvore pelo deslocamento e escala do ladrilho
+const char* tilePositionSource = R"(
+    uniform vec4 positionTile;  // deslocamento (xy) e escala (zw) do ladrilho
+    
+    vec2 tilePosition(vec2 quantized) {
+        return positionTile.xy + positionTile.zw * quantized;
+    }
+)";
+
+std::string buildVertexShader(const char* inputs, const char* body) {
+    return std::string("#version 330 core\n") + inputs + tilePositionSource + segmentStyleSource + body;
+}
+
+} // namespace
+
 bool TreeRenderer::initialize() {
-    const char* vertexShaderSource = R"(
+    std::string vertexShaderSource = buildVertexShader(R"(
+        layout (location = 0) in vec2 aPos;      // quantizada no ladrilho
+        layout (location = 1) in vec2 aMetrics;  // (profundidade, descendentes) normalizados
+        uniform mat4 transform;
+        flat out vec3 fragColor;     // cor do último vértice: o fim de cada segmento da faixa
+    )", R"(
+        void main() {
+            gl_Position = transform * vec4(tilePosition(aPos), 0.0, 1.0);
+            fragColor = segmentColor(aMetrics.x, aMetrics.y);
+        }
+    )");
+    
+    const char* fragmentShaderSource = R"(
         #version 330 core
-        layout (location = 0) in vec2 aPos;
-        layout (location = 1) in vec3 aColor;
+        flat in vec3 fragColor;
+        out vec4 FragColor;
+        
+        void main() {
+            FragColor = vec4(fragColor, 1.0);
+        }
+    )";
+    
+    shaderProgram = createShaderProgram(vertexShaderSource, fragmentShaderSource);
+    if (!shaderProgram) return false;
+    
+    // Segmentos largos: cada segmento é uma instância de um quad expandido
+    // no vertex shader, com a largura em pixels derivada dos descendentes
+    std::string wideVertexShaderSource = buildVertexShader(R"(
+        layout (location = 0) in vec2 aCorner;   // x: 0 = início, 1 = fim; y: lado (-1 ou 1)
+        layout (location = 1) in vec4 aSegment;  // (x0, y0, x1, y1) quantizados no ladrilho
+        layout (location = 2) in vec2 aMetrics;  // (profundidade, descendentes) normalizados
         uniform mat4 transform;
+        uniform vec2 viewportSize;
         out vec3 fragColor;
+        out float edgeDistance;
+        flat out float halfWidth;
+    )", R"(
+        void main() {
+            vec2 halfViewport = 0.5 * viewportSize;
+            vec2 p0 = (transform * vec4(tilePosition(aSegment.xy), 0.0, 1.0)).xy * halfViewport;
+            vec2 p1 = (transform * vec4(tilePosition(aSegment.zw), 0.0, 1.0)).xy * halfViewport;
+            
+            vec2 dir = p1 - p0;
+            float len = length(dir);
+            dir = (len > 0.0) ? dir / len : vec2(1.0, 0.0);
+            vec2 normal = vec2(-dir.y, dir.x);
+            
+            // Meio pixel extra nas laterais para a borda suavizada
+            halfWidth = 0.5 * segmentThickness(aMetrics.y);
+            float extent = halfWidth + 0.5;
+            vec2 pos = mix(p0, p1, aCorner.x)
+                     + dir * (aCorner.x * 2.0 - 1.0) * halfWidth
+                     + normal * aCorner.y * extent;
+            
+            gl_Position = vec4(pos / halfViewport, 0.0, 1.0);
+            fragColor = segmentColor(aMetrics.x, aMetrics.y);
+            edgeDistance = aCorner.y * extent;
+        }
+    )");
+    
+    const char* wideFragmentShaderSource = R"(
+        #version 330 core
+        in vec3 fragColor;
+        in float edgeDistance;
+        flat in float halfWidth;
+        out vec4 FragColor;
         
         void main() {
-            gl_Position = transform * vec4(aPos, 0.0, 1.0);
-            fragColor = aColor;
+            float coverage = clamp(halfWidth + 0.5 - abs(edgeDistance), 0.0, 1.0);
+            FragColor = vec4(fragColor, coverage);
         }
     )";
     
-    const char* fragmentShaderSource = R"(
+    wideProgram = createShaderProgram(wideVertexShaderSource, wideFragmentShaderSource);
+    if (!wideProgram) return false;
+    
+    // Vasos: o mesmo quad instanciado cobre a cápsula afunilada entre os raios
+    // inicial e final; o fragment shader avalia sua função de distância em
+    // pixels, o que dá a largura real do vaso e a borda suavizada
+    std::string capsuleVertexShaderSource = buildVertexShader(R"(
+        layout (location = 0) in vec2 aCorner;
+        layout (location = 1) in vec4 aSegment;
+        layout (location = 2) in vec2 aMetrics;
+        layout (location = 3) in vec2 aRadii;    // (raio inicial, raio final)
+        uniform mat4 transform;
+        uniform vec2 viewportSize;
+        uniform float radiusScale;
+        out vec3 fragColor;
+        out vec2 pixelPos;
+        flat out vec2 startPos;
+        flat out vec2 endPos;
+        flat out vec2 radii;
+    )", R"(
+        void main() {
+            vec2 halfViewport = 0.5 * viewportSize;
+            vec2 p0 = (transform * vec4(tilePosition(aSegment.xy), 0.0, 1.0)).xy * halfViewport;
+            vec2 p1 = (transform * vec4(tilePosition(aSegment.zw), 0.0, 1.0)).xy * halfViewport;
+            
+            // Escala uniforme da câmera convertida para pixels; vasos menores
+            // que um pixel continuam visíveis com largura mínima
+            float pixelsPerUnit = length(transform[0].xy) * sqrt(halfViewport.x * halfViewport.y);
+            vec2 r = max(aRadii * radiusScale * pixelsPerUnit, vec2(0.5));
+            
+            vec2 dir = p1 - p0;
+            float len = length(dir);
+            dir = (len > 0.0) ? dir / len : vec2(1.0, 0.0);
+            vec2 normal = vec2(-dir.y, dir.x);
+            
+            // Caixa orientada que contém a cápsula mais um pixel de margem
+            float side = max(r.x, r.y) + 1.0;
+            vec2 pos = mix(p0 - dir * (r.x + 1.0), p1 + dir * (r.y + 1.0), aCorner.x)
+                     + normal * aCorner.y * side;
+            
+            gl_Position = vec4(pos / halfViewport, 0.0, 1.0);
+            fragColor = segmentColor(aMetrics.x, aMetrics.y);
+            pixelPos = pos;
+            startPos = p0;
+            endPos = p1;
+            radii = r;
+        }
+    )");
+    
+    const char* capsuleFragmentShaderSource = R"(
         #version 330 core
         in vec3 fragColor;
+        in vec2 pixelPos;
+        flat in vec2 startPos;
+        flat in vec2 endPos;
+        flat in vec2 radii;
         out vec4 FragColor;
         
+        float cross2(vec2 a, vec2 b) { return a.x * b.y - a.y * b.x; }
+        
+        // Distância com sinal até a cápsula afunilada (dois círculos de raios
+        // ra e rb unidos pelas tangentes externas)
+        float taperedCapsule(vec2 p, vec2 pa, vec2 pb, float ra, float rb) {
+            p -= pa;
+            pb -= pa;
+            float h = dot(pb, pb);
+            float b = ra - rb;
+            
+            // Um círculo contém o outro: a cápsula é o maior deles
+            if (h <= b * b) return min(length(p) - ra, length(p - pb) - rb);
+            
+            vec2 q = vec2(dot(p, vec2(pb.y, -pb.x)), dot(p, pb)) / h;
+            q.x = abs(q.x);
+            vec2 c = vec2(sqrt(h - b * b), b);
+            
+            float k = cross2(c, q);
+            float m = dot(c, q);
+            float n = dot(q, q);
+            
+            if (k < 0.0) return sqrt(h * n) - ra;
+            if (k > c.x) return sqrt(h * (n + 1.0 - 2.0 * q.y)) - rb;
+            return m - ra;
+        }
+        
         void main() {
-            FragColor = vec4(fragColor, 1.0);
+            float dist = taperedCapsule(pixelPos, startPos, endPos, radii.x, radii.y);
+            float coverage = clamp(0.5 - dist, 0.0, 1.0);
+            if (coverage <= 0.0) discard;
+            FragColor = vec4(fragColor, coverage);
         }
     )";
     
-    shaderProgram = createShaderProgram(vertexShaderSource, fragmentShaderSource);
-    if (!shaderProgram) return false;
+    capsuleProgram = createShaderProgram(capsuleVertexShaderSource, capsuleFragmentShaderSource);
+    if (!capsuleProgram) return false;
+    
+    const float quadCorners[] = {
+        0.0f, -1.0f,
+        0.0f,  1.0f,
+        1.0f, -1.0f,
+        1.0f,  1.0f
+    };
+    
+    glGenBuffers(1, &quadVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadCorners), quadCorners, GL_STATIC_DRAW);
     
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
+    // As instâncias da árvore inteira ficam nos buffers de cada árvore; este
+    // VAO recebe as do corte de LOD, e é configurado a cada envio
+    glGenVertexArrays(1, &cutQuadVAO);
+    glGenBuffers(1, &cutInstanceVBO);
     
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    std::cout << "TreeRenderer inicializado com sucesso" << std::endl;
+    return true;
+}
+
+void TreeRenderer::setupLineVertexArray(unsigned int vao, unsigned int vertexBuffer, unsigned int indexBuffer) {
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
     
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glVertexAttribPointer(0, 2, GL_SHORT, GL_FALSE, sizeof(LineVertex), (void*)offsetof(LineVertex, x));
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(2 * sizeof(float)));
+    glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(LineVertex), (void*)offsetof(LineVertex, depth));
     glEnableVertexAttribArray(1);
     
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void TreeRenderer::setupQuadVertexArray(unsigned int vao, unsigned int instanceBuffer, size_t instanceCount) {
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    setupInstanceAttributes(instanceBuffer, instanceCount, 0);
     
-    std::cout << "TreeRenderer inicializado com sucesso" << std::endl;
-    return true;
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void TreeRenderer::setupInstanceAttributes(unsigned int instanceBuffer, size_t instanceCount, size_t firstInstance) {
+    // Blocos consecutivos do buffer de instâncias (ver writeInstanceBlocks),
+    // a partir da instância firstInstance de cada um; o VAO já está ligado
+    size_t offsets[instanceBlockCount + 1];
+    instanceBlockOffsets(instanceCount, offsets);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    for (int block = 0; block < instanceBlockCount; block++) {
+        const InstanceBlock& format = instanceBlocks[block];
+        size_t stride = format.components * format.componentBytes;
+        glVertexAttribPointer(format.location, format.components, format.type, format.normalized ? GL_TRUE : GL_FALSE,
+                              static_cast<GLsizei>(stride), (void*)(offsets[block] + firstInstance * stride));
+        glEnableVertexAttribArray(format.location);
+        glVertexAttribDivisor(format.location, 1);
+    }
+}
+
+TreeRenderer::PreparedTree::~PreparedTree() {
+    if (lineVAO) glDeleteVertexArrays(1, &lineVAO);
+    if (lineVBO) glDeleteBuffers(1, &lineVBO);
+    if (lineEBO) glDeleteBuffers(1, &lineEBO);
+    if (quadVAO) glDeleteVertexArrays(1, &quadVAO);
+    if (instanceVBO) glDeleteBuffers(1, &instanceVBO);
+}
+
+size_t TreeRenderer::PreparedTree::memoryUsage() const {
+    // Dados em CPU mais os buffers da GPU: faixas de linhas (8 bytes por
+    // vértice e seus índices) e instâncias (ver instanceBlocks)
+    size_t bytes = (vertices.capacity() + normalizedDepth.capacity() + normalizedDescendants.capacity() +
+                    radii.capacity() + tilePositionScales.capacity()) * sizeof(float) +
+                   (subtreeSize.capacity() + parentOrder.capacity() + chainOffsets.capacity() +
+                    lineStartIndex.capacity() + lineStartVertex.capacity()) * sizeof(int) +
+                   quantizedVertices.capacity() * sizeof(int16_t) + quantizedMetrics.capacity() * sizeof(uint16_t) +
+                   tileRanges.capacity() * sizeof(DrawRange);
+    bytes += lod.memoryUsage();
+    bytes += lineVertexCount * sizeof(LineVertex) + lineIndexCount * sizeof(unsigned int);
+    
+    size_t instanceOffsets[instanceBlockCount + 1];
+    instanceBlockOffsets(segmentCount, instanceOffsets);
+    bytes += instanceOffsets[instanceBlockCount];
+    return bytes;
 }
 
-int TreeRenderer::findRootSegment(const std::vector<Segment>& segments) {
-    if (segments.empty()) return -1;
+template <typename Real, typename Index>
+void TreeRenderer::setTree(const BasicSegmentTable<Real, Index>& segments, const BasicTreeTopology<Index>& topology,
+                           const std::string& cacheKey) {
+    // Árvore já preparada: reaproveita dados e buffers sem reenviar nada
+    if (std::shared_ptr<PreparedTree>* cached = treeCache.find(cacheKey)) {
+        tree = *cached;
+        tree->drawInstancesDirty = true;    // o buffer do corte é compartilhado entre árvores
+        return;
+    }
     
-    std::vector<bool> hasParent(segments.size(), false);
+    TreeRenderBackend::setTree(segments, topology);
+    if (tree->segmentCount > 0) {
+        treeCache.insert(cacheKey, tree, tree->memoryUsage());
+    }
+}
+
+#define INSTANTIATE_RENDERER_TREE(Real, Index) \
+    template void TreeRenderer::setTree(const BasicSegmentTable<Real, Index>&, const BasicTreeTopology<Index>&, \
+                                        const std::string&);
+TREE_MODEL_TYPES(INSTANTIATE_RENDERER_TREE)
+#undef INSTANTIATE_RENDERER_TREE
+
+CacheStats TreeRenderer::getCacheStats() const {
+    return treeCache.getStats();
+}
+
+void TreeRenderer::prepareTree(SegmentData&& data) {
+    tree = std::make_shared<PreparedTree>();
+    static_cast<SegmentData&>(*tree) = std::move(data);
+    if (tree->segmentCount == 0) return;
+    
+    quantizeTree(*tree);
+    
+    // Faixas de linhas: um segmento continua a faixa do anterior na pré-ordem
+    // quando começa exatamente onde ele termina (sempre o caso dentro de uma
+    // polyline) e está no mesmo ladrilho; senão abre uma faixa nova, após um
+    // índice de restart, a partir do vértice do fim do pai
+    size_t count = tree->segmentCount;
+    const float* vertices = tree->vertices.data();
+    tree->lineStartIndex.resize(count);
+    tree->lineStartVertex.resize(count);
+    size_t vertexCount = count, indexCount = 0;
+    size_t nextTile = 1;
+    int tileBegin = 0;
+    for (size_t i = 0; i < count; i++) {
+        const float* v = &vertices[i * 4];
+        bool startsTile = nextTile < tree->tileRanges.size() &&
+                          static_cast<int>(i) == tree->tileRanges[nextTile].begin;
+        if (startsTile) tileBegin = tree->tileRanges[nextTile++].begin;
+        bool continues = i > 0 && !startsTile && v[0] == v[-2] && v[1] == v[-1];
+        
+        // Vértices são quantizados no ladrilho: o pai só é compartilhado
+        // dentro do mesmo
+        int parent = tree->parentOrder[i];
+        bool sharesParent = parent >= tileBegin &&
+                            v[0] == vertices[static_cast<size_t>(parent) * 4 + 2] &&
+                            v[1] == vertices[static_cast<size_t>(parent) * 4 + 3];
+        if (continues) {
+            tree->lineStartVertex[i] = static_cast<int>(i) - 1;
+        } else {
+            tree->lineStartVertex[i] = sharesParent ? parent : static_cast<int>(vertexCount++);
+            if (i > 0) indexCount++;
+            indexCount++;
+        }
+        tree->lineStartIndex[i] = static_cast<int>(indexCount - 1);
+        indexCount++;
+    }
+    tree->lineVertexCount = vertexCount;
+    tree->lineIndexCount = indexCount;
     
-    for (size_t i = 0; i < segments.size(); i++) {
-        for (size_t j = 0; j < segments.size(); j++) {
-            if (i == j) continue;
-            
-            // Verifica se o segmento j termina onde o segmento i começa
-            float dist = std::abs(segments[j].end.x - segments[i].start.x) + 
-                       std::abs(segments[j].end.y - segments[i].start.y);
-            if (dist < 0.001f) {
-                hasParent[i] = true;
-                break;
+    tree->dirty = true;
+    tree->lod.build(tree->vertices, tree->subtreeSize, tree->chainOffsets);
+    tree->bvh.build(tree->vertices, tree->radii, tree->radiusScale);
+}
+
+void TreeRenderer::quantizeTree(PreparedTree& prepared) const {
+    const float* vertices = prepared.vertices.data();
+    size_t count = prepared.segmentCount;
+    
+    // Ladrilhos: segmentos seguidos na pré-ordem enquanto a caixa que os
+    // contém couber no tamanho pedido; um segmento maior fica em um só seu
+    std::vector<BoundingBox> boxes;
+    prepared.tileRanges.clear();
+    BoundingBox box = segmentBox(vertices);
+    int begin = 0;
+    for (size_t i = 1; i < count; i++) {
+        BoundingBox next = segmentBox(vertices + i * 4);
+        BoundingBox merged = {std::min(box.minX, next.minX), std::min(box.minY, next.minY),
+                              std::max(box.maxX, next.maxX), std::max(box.maxY, next.maxY)};
+        if (quantizationTileSize > 0.0f && merged.extent() > quantizationTileSize) {
+            prepared.tileRanges.push_back({begin, static_cast<int>(i)});
+            boxes.push_back(box);
+            begin = static_cast<int>(i);
+            box = next;
+        } else {
+            box = merged;
+        }
+    }
+    prepared.tileRanges.push_back({begin, static_cast<int>(count)});
+    boxes.push_back(box);
+    
+    // Cada ladrilho usa toda a faixa do int16 em cada eixo
+    prepared.tilePositionScales.resize(boxes.size() * 4);
+    prepared.quantizedVertices.resize(count * 4);
+    for (size_t t = 0; t < boxes.size(); t++) {
+        float* tile = &prepared.tilePositionScales[t * 4];
+        tile[0] = 0.5f * (boxes[t].minX + boxes[t].maxX);
+        tile[1] = 0.5f * (boxes[t].minY + boxes[t].maxY);
+        tile[2] = boxes[t].maxX > boxes[t].minX ? 0.5f * (boxes[t].maxX - boxes[t].minX) / quantizedPositionMax : 1.0f;
+        tile[3] = boxes[t].maxY > boxes[t].minY ? 0.5f * (boxes[t].maxY - boxes[t].minY) / quantizedPositionMax : 1.0f;
+        
+        for (int i = prepared.tileRanges[t].begin; i < prepared.tileRanges[t].end; i++) {
+            size_t first = static_cast<size_t>(i) * 4;
+            for (int k = 0; k < 4; k++) {
+                int axis = k % 2;
+                prepared.quantizedVertices[first + k] = quantizePosition(vertices[first + k], tile[axis], tile[2 + axis]);
             }
         }
     }
     
-    for (size_t i = 0; i < segments.size(); i++) {
-        if (!hasParent[i]) return static_cast<int>(i);
+    prepared.quantizedMetrics.resize(count * 2);
+    for (size_t i = 0; i < count; i++) {
+        prepared.quantizedMetrics[i * 2] = quantizeUnit(prepared.normalizedDepth[i]);
+        prepared.quantizedMetrics[i * 2 + 1] = quantizeUnit(prepared.normalizedDescendants[i]);
     }
-    
-    return 0;
 }
 
-void TreeRenderer::buildAdjacencyList(const std::vector<Segment>& segments,
-                                    std::vector<std::vector<int>>& children) {
-    children.clear();
-    children.resize(segments.size());
+void TreeRenderer::applyTransform(const float* transformMatrix) {
+    TreeRenderBackend::applyTransform(transformMatrix);
     
-    for (size_t i = 0; i < segments.size(); i++) {
-        for (size_t j = 0; j < segments.size(); j++) {
-            if (i == j) continue;
-            
-            float dist = std::abs(segments[j].start.x - segments[i].end.x) + 
-                       std::abs(segments[j].start.y - segments[i].end.y);
-            if (dist < 0.001f) {
-                children[i].push_back(static_cast<int>(j));
-            }
+    for (unsigned int program : {shaderProgram, wideProgram, capsuleProgram}) {
+        glUseProgram(program);
+        GLint transformLoc = glGetUniformLocation(program, "transform");
+        if (transformLoc != -1) {
+            glUniformMatrix4fv(transformLoc, 1, GL_FALSE, transformMatrix);
         }
     }
 }
 
-void TreeRenderer::calculateNodeInfo(const std::vector<Segment>& segments,
-                                   std::vector<int>& depth,
-                                   std::vector<int>& descendantCount) {
-    depth.resize(segments.size(), -1);
-    descendantCount.resize(segments.size(), 0);
+void TreeRenderer::render() {
+    if (tree->segmentCount == 0) return;
     
-    if (segments.empty()) return;
-    
-    std::vector<std::vector<int>> children;
-    buildAdjacencyList(segments, children);
+    // Os buffers só são reenviados quando a árvore muda; os modos de
+    // visualização são uniforms
+    if (tree->dirty) {
+        uploadRenderData();
+    }
     
-    int root = findRootSegment(segments);
-    if (root == -1) return;
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
     
-    // Calcula profundidade usando BFS
-    std::queue<int> q;
-    depth[root] = 0;
-    q.push(root);
+    updateDrawRanges(viewport[2], viewport[3]);
+    renderSegments(viewport[2], viewport[3]);
+}
+
+bool TreeRenderer::updateLevelOfDetail(int viewportWidth, int viewportHeight) {
+    // Escala da câmera em pixels por unidade (a matriz só tem rotação e escala uniforme)
+    float scale = std::sqrt(transform[0] * transform[0] + transform[1] * transform[1]);
+    float pixelsPerUnit = scale * 0.5f * static_cast<float>(std::max(viewportWidth, viewportHeight));
+    
+    if (tree->cutPixelsPerUnit > 0.0f &&
+        std::abs(pixelsPerUnit - tree->cutPixelsPerUnit) <= lodScaleTolerance * tree->cutPixelsPerUnit) {
+        return false;
+    }
     
-    while (!q.empty()) {
-        int current = q.front();
-        q.pop();
-        
-        for (int child : children[current]) {
-            if (depth[child] == -1) {
-                depth[child] = depth[current] + 1;
-                q.push(child);
-            }
+    tree->cutPixelsPerUnit = pixelsPerUnit;
+    tree->lod.selectCut(pixelsPerUnit, lodMinPixels, tree->cutRanges);
+    return true;
+}
+
+bool TreeRenderer::updateVisibleRegion(int viewportWidth, int viewportHeight) {
+    // Cantos da tela (com margem) levados de volta ao espaço da árvore pela
+    // inversa da transformação 2D
+    float a = transform[0], b = transform[1], c = transform[4], d = transform[5];
+    float det = a * d - b * c;
+    if (std::abs(det) < 1e-12f) return false;
+    
+    float marginX = 1.0f + 2.0f * viewMarginPixels / static_cast<float>(std::max(viewportWidth, 1));
+    float marginY = 1.0f + 2.0f * viewMarginPixels / static_cast<float>(std::max(viewportHeight, 1));
+    
+    BoundingBox view = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                        std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+    for (float sx : {-marginX, marginX}) {
+        for (float sy : {-marginY, marginY}) {
+            float px = sx - transform[12];
+            float py = sy - transform[13];
+            float x = ( d * px - c * py) / det;
+            float y = (-b * px + a * py) / det;
+            view.minX = std::min(view.minX, x);
+            view.minY = std::min(view.minY, y);
+            view.maxX = std::max(view.maxX, x);
+            view.maxY = std::max(view.maxY, y);
         }
     }
     
-    // Calcula número de descendentes recursivamente
-    std::function<int(int)> calculateDescendants = [&](int node) -> int {
-        int count = 0;
-        for (int child : children[node]) {
-            count += 1 + calculateDescendants(child);
-        }
-        descendantCount[node] = count;
-        return count;
-    };
+    // A consulta anterior continua válida enquanto a vista estiver dentro da região consultada
+    const BoundingBox& queried = tree->queriedRegion;
+    if (tree->hasQueriedRegion &&
+        view.minX >= queried.minX && view.maxX <= queried.maxX &&
+        view.minY >= queried.minY && view.maxY <= queried.maxY) {
+        return false;
+    }
     
-    calculateDescendants(root);
+    float padX = (view.maxX - view.minX) * viewQueryPadding;
+    float padY = (view.maxY - view.minY) * viewQueryPadding;
+    tree->queriedRegion = {view.minX - padX, view.minY - padY, view.maxX + padX, view.maxY + padY};
+    tree->hasQueriedRegion = true;
+    tree->bvh.query(tree->queriedRegion, tree->visibleRanges);
+    return true;
 }
 
-TreeRenderer::RenderData TreeRenderer::prepareRenderData(const std::vector<Segment>& segments) {
-    RenderData data;
-    
-    if (segments.empty()) return data;
-    
-    // Calcula informações dos nós
-    std::vector<int> depth;
-    std::vector<int> descendantCount;
-    calculateNodeInfo(segments, depth, descendantCount);
-    
-    // Encontra valores máximos para normalização
-    int maxDepth = *std::max_element(depth.begin(), depth.end());
-    int maxDescendants = *std::max_element(descendantCount.begin(), descendantCount.end());
-    
-    if (maxDepth == 0) maxDepth = 1;
-    if (maxDescendants == 0) maxDescendants = 1;
-    
-    // Prepara dados de renderização
-    data.vertices.reserve(segments.size() * 4);
-    data.colors.reserve(segments.size() * 6);
-    data.thicknesses.reserve(segments.size());
-    
-    for (size_t i = 0; i < segments.size(); i++) {
-        const auto& segment = segments[i];
-        float normalizedDepth = static_cast<float>(depth[i]) / maxDepth;
-        float normalizedDescendants = static_cast<float>(descendantCount[i]) / maxDescendants;
-        
-        // Calcula cor
-        float r, g, b;
-        
-        if (useMonochrome) {
-            r = 0.0f;
-            g = 1.0f;
-            b = 0.0f;
-        } else if (gradientMode) {
-            // Gradiente bottom-up: Violeta (folhas) -> Vermelho (raiz)
-            r = 1.0f - normalizedDepth * 0.5f;
-            g = 0.0f;
-            b = normalizedDepth * 0.5f;
-        } else if (descendantsColorMode) {
-            // Gradiente por número de descendentes 
-            r = sqrt(normalizedDescendants);           
-            g = 0.0f;
-            b = 1.0f - normalizedDescendants * normalizedDescendants;    
-        } else {
-            r = g = b = 1.0f;
+void TreeRenderer::updateDrawRanges(int viewportWidth, int viewportHeight) {
+    bool cutChanged = updateLevelOfDetail(viewportWidth, viewportHeight);
+    bool viewChanged = updateVisibleRegion(viewportWidth, viewportHeight);
+    if (!cutChanged && !viewChanged) return;
+    
+    // Desenha o que está no corte de LOD e dentro da vista, com os trechos
+    // divididos nas bordas dos ladrilhos
+    std::vector<DrawRange> selected;
+    intersectRanges(tree->cutRanges, tree->visibleRanges, selected);
+    intersectRanges(selected, tree->tileRanges, tree->drawRanges);
+    
+    // Cada trecho vai do vértice inicial do primeiro segmento ao final do
+    // último; os restarts no meio separam as faixas
+    tree->drawSegmentCount = 0;
+    tree->drawLineOffsets.clear();
+    tree->drawLineCounts.clear();
+    tree->drawTiles.clear();
+    size_t tile = 0;
+    for (size_t r = 0; r < tree->drawRanges.size(); r++) {
+        const DrawRange& range = tree->drawRanges[r];
+        while (tree->tileRanges[tile].end <= range.begin) tile++;
+        if (tree->drawTiles.empty() || tree->drawTiles.back().tile != tile) {
+            tree->drawTiles.push_back({tile, r, 0, tree->drawSegmentCount, 0});
         }
+        tree->drawTiles.back().rangeCount++;
+        tree->drawTiles.back().instanceCount += range.end - range.begin;
         
-        // Calcula espessura
-        float thickness = lineWidth;
-        if (thicknessMode) {
-            // ESPESSURA BASEADA NO NÚMERO DE DESCENDENTES
-            thickness = 2.0f + normalizedDescendants * 13.0f;
-        }
-        
-        // Adiciona vértices e cores
-        data.vertices.push_back(segment.start.x);
-        data.vertices.push_back(segment.start.y);
-        data.colors.push_back(r);
-        data.colors.push_back(g);
-        data.colors.push_back(b);
-        
-        data.vertices.push_back(segment.end.x);
-        data.vertices.push_back(segment.end.y);
-        data.colors.push_back(r);
-        data.colors.push_back(g);
-        data.colors.push_back(b);
-        
-        data.thicknesses.push_back(thickness);
+        int first = tree->lineStartIndex[range.begin];
+        int last = tree->lineStartIndex[range.end - 1] + 1;
+        tree->drawSegmentCount += range.end - range.begin;
+        tree->drawLineOffsets.push_back(reinterpret_cast<const void*>(static_cast<size_t>(first) * sizeof(unsigned int)));
+        tree->drawLineCounts.push_back(last - first + 1);
     }
-    
-    return data;
+    tree->drawInstancesDirty = true;
 }
 
-void TreeRenderer::applyTransform(const float* transformMatrix) {
-    glUseProgram(shaderProgram);
-    GLuint transformLoc = glGetUniformLocation(shaderProgram, "transform");
-    if (transformLoc != -1) {
-        glUniformMatrix4fv(transformLoc, 1, GL_FALSE, transformMatrix);
+// 20 bytes por segmento: a metade das coordenadas em float
+const TreeRenderer::InstanceBlock TreeRenderer::instanceBlocks[instanceBlockCount] = {
+    {1, 4, GL_SHORT, false, sizeof(int16_t)},           // (x0, y0, x1, y1) quantizados
+    {3, 2, GL_FLOAT, false, sizeof(float)},             // raio inicial e final
+    {2, 2, GL_UNSIGNED_SHORT, true, sizeof(uint16_t)}   // profundidade e descendentes
+};
+
+void TreeRenderer::instanceBlockOffsets(size_t instanceCount, size_t* offsets) {
+    size_t offset = 0;
+    for (int block = 0; block < instanceBlockCount; block++) {
+        offsets[block] = offset;
+        offset += instanceCount * instanceBlocks[block].components * instanceBlocks[block].componentBytes;
     }
+    offsets[instanceBlockCount] = offset;
 }
 
-void TreeRenderer::render(const std::vector<Segment>& segments) {
-    static bool firstRender = true;
-    
-    if (segments.empty()) {
-        if (firstRender) {
-            std::cout << "Nenhuma árvore carregada, renderizando árvore de teste..." << std::endl;
-            firstRender = false;
+void TreeRenderer::writeInstanceBlocks(const PreparedTree& data, const DrawRange* ranges, size_t rangeCount,
+                                       size_t instanceCount, unsigned int usage) {
+    // Os trechos de cada array vão direto para o buffer, sem cópia intermediária
+    size_t offsets[instanceBlockCount + 1];
+    instanceBlockOffsets(instanceCount, offsets);
+    glBufferData(GL_ARRAY_BUFFER, offsets[instanceBlockCount], nullptr, usage);
+    
+    const void* arrays[instanceBlockCount] = {
+        data.quantizedVertices.data(), data.radii.data(), data.quantizedMetrics.data()
+    };
+    for (int block = 0; block < instanceBlockCount; block++) {
+        size_t stride = instanceBlocks[block].components * instanceBlocks[block].componentBytes;
+        size_t offset = offsets[block];
+        for (size_t r = 0; r < rangeCount; r++) {
+            size_t bytes = (ranges[r].end - ranges[r].begin) * stride;
+            glBufferSubData(GL_ARRAY_BUFFER, offset, bytes,
+                            static_cast<const char*>(arrays[block]) + ranges[r].begin * stride);
+            offset += bytes;
         }
-        std::vector<Segment> testSegments = createTestTree();
-        renderSegments(testSegments);
-        return;
+    }
+}
+
+void TreeRenderer::uploadRenderData() {
+    tree->dirty = false;
+    
+    // Linhas: um vértice por ponto, já quantizado. O fim de cada segmento
+    // leva a profundidade e os descendentes dele, e é o último vértice da
+    // linha (o que dá a cor); os inícios só precisam da posição.
+    std::vector<LineVertex> vertexData(tree->lineVertexCount);
+    std::vector<unsigned int> indexData;
+    indexData.reserve(tree->lineIndexCount);
+    
+    for (size_t i = 0; i < tree->segmentCount; i++) {
+        const int16_t* v = &tree->quantizedVertices[i * 4];
+        const uint16_t* metrics = &tree->quantizedMetrics[i * 2];
+        vertexData[i] = {v[2], v[3], metrics[0], metrics[1]};
+        
+        bool startsStrip = i == 0 || tree->lineStartIndex[i] != tree->lineStartIndex[i - 1] + 1;
+        if (startsStrip) {
+            size_t start = static_cast<size_t>(tree->lineStartVertex[i]);
+            if (start >= tree->segmentCount) vertexData[start] = {v[0], v[1], metrics[0], metrics[1]};
+            if (i > 0) indexData.push_back(lineRestartIndex);
+            indexData.push_back(static_cast<unsigned int>(start));
+        }
+        indexData.push_back(static_cast<unsigned int>(i));
     }
     
-    if (firstRender) {
-        std::cout << "Renderizando árvore com " << segments.size() << " segmentos" << std::endl;
-        firstRender = false;
+    if (!tree->lineVAO) {
+        glGenVertexArrays(1, &tree->lineVAO);
+        glGenBuffers(1, &tree->lineVBO);
+        glGenBuffers(1, &tree->lineEBO);
+        setupLineVertexArray(tree->lineVAO, tree->lineVBO, tree->lineEBO);
+        glGenVertexArrays(1, &tree->quadVAO);
+        glGenBuffers(1, &tree->instanceVBO);
+        setupQuadVertexArray(tree->quadVAO, tree->instanceVBO, tree->segmentCount);
     }
     
-    renderSegments(segments);
+    glBindBuffer(GL_ARRAY_BUFFER, tree->lineVBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(LineVertex), 
+                vertexData.data(), GL_STATIC_DRAW);
+    
+    // Quads: uma instância por segmento, com os arrays da árvore copiados
+    // inteiros, cada um para o seu bloco do buffer
+    DrawRange allSegments = {0, static_cast<int>(tree->segmentCount)};
+    glBindBuffer(GL_ARRAY_BUFFER, tree->instanceVBO);
+    writeInstanceBlocks(*tree, &allSegments, 1, tree->segmentCount, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    // O buffer de índices pertence ao VAO das linhas
+    glBindVertexArray(tree->lineVAO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, tree->lineEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexData.size() * sizeof(unsigned int),
+                indexData.data(), GL_STATIC_DRAW);
+    glBindVertexArray(0);
 }
 
-std::vector<Segment> TreeRenderer::createTestTree() {
-    std::vector<Segment> testSegments;
-    
-    // Tronco principal
-    testSegments.emplace_back(Point2D(0.0f, -1.0f), Point2D(0.0f, -0.5f), 0.1f, 0.08f);
-    
-    // Ramos primários
-    testSegments.emplace_back(Point2D(0.0f, -0.5f), Point2D(0.3f, -0.2f), 0.08f, 0.06f);
-    testSegments.emplace_back(Point2D(0.0f, -0.5f), Point2D(-0.3f, -0.2f), 0.08f, 0.06f);
-    
-    // Ramos secundários
-    testSegments.emplace_back(Point2D(0.3f, -0.2f), Point2D(0.5f, 0.1f), 0.06f, 0.04f);
-    testSegments.emplace_back(Point2D(-0.3f, -0.2f), Point2D(-0.5f, 0.1f), 0.06f, 0.04f);
-    
-    // Ramos terciários
-    testSegments.emplace_back(Point2D(0.5f, 0.1f), Point2D(0.6f, 0.4f), 0.04f, 0.02f);
-    testSegments.emplace_back(Point2D(0.5f, 0.1f), Point2D(0.4f, 0.4f), 0.04f, 0.02f);
-    testSegments.emplace_back(Point2D(-0.5f, 0.1f), Point2D(-0.6f, 0.4f), 0.04f, 0.02f);
-    testSegments.emplace_back(Point2D(-0.5f, 0.1f), Point2D(-0.4f, 0.4f), 0.04f, 0.02f);
-    
-    return testSegments;
+void TreeRenderer::applyStyleUniforms(unsigned int program) {
+    glUniform1i(glGetUniformLocation(program, "colorMode"), colorMode());
+    glUniform1i(glGetUniformLocation(program, "thicknessMode"), thicknessMode ? 1 : 0);
+    glUniform1f(glGetUniformLocation(program, "lineWidth"), lineWidth);
 }
 
-void TreeRenderer::renderSegments(const std::vector<Segment>& segments) {
-    RenderData data = prepareRenderData(segments);
-    
-    if (data.vertices.empty()) return;
-    
-    if (thicknessMode && !data.thicknesses.empty()) {
-        // Renderiza segmento por segmento com espessuras diferentes
-        for (size_t i = 0; i < segments.size(); i++) {
-            float thickness = std::clamp(data.thicknesses[i], 1.0f, 10.0f);
-            glLineWidth(thickness);
-            
-            std::vector<float> segmentData;
-            size_t baseIdx = i * 2;
-            
-            // Vértice inicial
-            segmentData.insert(segmentData.end(), {
-                data.vertices[baseIdx * 2],
-                data.vertices[baseIdx * 2 + 1],
-                data.colors[baseIdx * 3],
-                data.colors[baseIdx * 3 + 1],
-                data.colors[baseIdx * 3 + 2]
-            });
-            
-            // Vértice final
-            segmentData.insert(segmentData.end(), {
-                data.vertices[(baseIdx + 1) * 2],
-                data.vertices[(baseIdx + 1) * 2 + 1],
-                data.colors[(baseIdx + 1) * 3],
-                data.colors[(baseIdx + 1) * 3 + 1],
-                data.colors[(baseIdx + 1) * 3 + 2]
-            });
-            
-            glBindVertexArray(VAO);
-            glBindBuffer(GL_ARRAY_BUFFER, VBO);
-            glBufferData(GL_ARRAY_BUFFER, segmentData.size() * sizeof(float), 
-                        segmentData.data(), GL_STATIC_DRAW);
-            glDrawArrays(GL_LINES, 0, 2);
+void TreeRenderer::renderSegments(int viewportWidth, int viewportHeight) {
+    if (tree->drawSegmentCount == 0) return;
+    bool fullTree = tree->drawSegmentCount == tree->segmentCount;
+    bool tiled = tree->tileRanges.size() > 1;
+    
+    if (vesselMode || thicknessMode) {
+        // Segmentos largos em uma única chamada instanciada por ladrilho; com
+        // o corte de LOD ou a vista limitando os segmentos, as instâncias
+        // selecionadas são compactadas em um buffer próprio
+        if (!fullTree && tree->drawInstancesDirty) {
+            glBindBuffer(GL_ARRAY_BUFFER, cutInstanceVBO);
+            writeInstanceBlocks(*tree, tree->drawRanges.data(), tree->drawRanges.size(),
+                                tree->drawSegmentCount, GL_STREAM_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            setupQuadVertexArray(cutQuadVAO, cutInstanceVBO, tree->drawSegmentCount);
+            tree->drawInstancesDirty = false;
         }
-    } else {
-        // Renderiza todos os segmentos de uma vez
-        glLineWidth(lineWidth);
         
-        std::vector<float> interleavedData;
-        interleavedData.reserve(data.vertices.size() / 2 * 5);
+        unsigned int program = vesselMode ? capsuleProgram : wideProgram;
+        glUseProgram(program);
+        applyStyleUniforms(program);
+        glUniform2f(glGetUniformLocation(program, "viewportSize"), 
+                   static_cast<float>(viewportWidth), static_cast<float>(viewportHeight));
+        glUniform1f(glGetUniformLocation(program, "radiusScale"), tree->radiusScale);
+        GLint tileLoc = glGetUniformLocation(program, "positionTile");
         
-        for (size_t i = 0; i < data.vertices.size() / 2; i++) {
-            interleavedData.push_back(data.vertices[i * 2]);
-            interleavedData.push_back(data.vertices[i * 2 + 1]);
-            interleavedData.push_back(data.colors[i * 3]);
-            interleavedData.push_back(data.colors[i * 3 + 1]);
-            interleavedData.push_back(data.colors[i * 3 + 2]);
+        // A cobertura das bordas mistura só as cores; o alfa de destino
+        // continua opaco, para que as imagens exportadas não tenham halos
+        glEnable(GL_BLEND);
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        glBindVertexArray(fullTree ? tree->quadVAO : cutQuadVAO);
+        for (const PreparedTree::TileBatch& batch : tree->drawTiles) {
+            // Sem instância base no GL 3.3: os atributos passam a apontar
+            // para a primeira instância do ladrilho
+            if (tiled) {
+                setupInstanceAttributes(fullTree ? tree->instanceVBO : cutInstanceVBO,
+                                        tree->drawSegmentCount, batch.firstInstance);
+            }
+            glUniform4fv(tileLoc, 1, &tree->tilePositionScales[batch.tile * 4]);
+            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(batch.instanceCount));
         }
-        
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, interleavedData.size() * sizeof(float), 
-                    interleavedData.data(), GL_STATIC_DRAW);
-        glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(data.vertices.size() / 2));
+        glDisable(GL_BLEND);
+    } else {
+        // Renderiza todas as faixas de uma vez; os trechos visíveis do
+        // corte de LOD são enviados em uma única chamada por ladrilho
+        glUseProgram(shaderProgram);
+        applyStyleUniforms(shaderProgram);
+        GLint tileLoc = glGetUniformLocation(shaderProgram, "positionTile");
+        glLineWidth(lineWidth);
+        glEnable(GL_PRIMITIVE_RESTART);
+        glPrimitiveRestartIndex(lineRestartIndex);
+        glBindVertexArray(tree->lineVAO);
+        if (fullTree && !tiled) {
+            glUniform4fv(tileLoc, 1, tree->tilePositionScales.data());
+            glDrawElements(GL_LINE_STRIP, static_cast<GLsizei>(tree->lineIndexCount), GL_UNSIGNED_INT, nullptr);
+        } else {
+            for (const PreparedTree::TileBatch& batch : tree->drawTiles) {
+                glUniform4fv(tileLoc, 1, &tree->tilePositionScales[batch.tile * 4]);
+                glMultiDrawElements(GL_LINE_STRIP, tree->drawLineCounts.data() + batch.firstRange, GL_UNSIGNED_INT,
+                                   tree->drawLineOffsets.data() + batch.firstRange,
+                                   static_cast<GLsizei>(batch.rangeCount));
+            }
+        }
+        glDisable(GL_PRIMITIVE_RESTART);
     }
     
     glBindVertexArray(0);
@@ -1,53 +1,146 @@
 #ifndef TREERENDERER_H
 #define TREERENDERER_H
 
-#include "VTKLoader.h"
+#include "TreeRenderBackend.h"
+#include "TreeLOD.h"
+#include "SegmentBVH.h"
+#include "LRUCache.h"
 #include <vector>
 #include <string>
+#include <memory>
+#include <cstdint>
 
-class TreeRenderer {
+class TreeRenderer : public TreeRenderBackend {
 public:
     TreeRenderer();
-    ~TreeRenderer();
+    ~TreeRenderer() override;
     
-    bool initialize();
-    void render(const std::vector<Segment>& segments);
-    void setLineWidth(float width) { lineWidth = width; }
-    void applyTransform(const float* transformMatrix);
-    void setColorMode(bool monochrome) { useMonochrome = monochrome; }
-    void setGradientMode(bool enabled) { gradientMode = enabled; }
-    void setThicknessMode(bool enabled) { thicknessMode = enabled; }
-    void setDescendantsColorMode(bool enabled) { descendantsColorMode = enabled; }
+    bool initialize() override;
+    void cleanup() override;        // libera os objetos OpenGL antes de destruir o contexto
+    void render() override;
+    void applyTransform(const float* transformMatrix) override;
+    
+    // Árvores preparadas, com seus buffers na GPU, ficam em cache pela chave
+    // (caminho e data de modificação); voltar a uma delas não reenvia nada
+    using TreeRenderBackend::setTree;
+    template <typename Real, typename Index>
+    void setTree(const BasicSegmentTable<Real, Index>& segments, const BasicTreeTopology<Index>& topology,
+                 const std::string& cacheKey);
+    void setCacheBudget(size_t bytes) { treeCache.setBudget(bytes); }
+    CacheStats getCacheStats() const;
+    
+    // Posições vão para a GPU em int16 relativas a ladrilhos de no máximo
+    // size unidades de lado, cada um com seu deslocamento e escala; 0 (padrão)
+    // usa um só ladrilho para a árvore toda. Ladrilhos menores mantêm a
+    // precisão em zoom profundo. Vale para as árvores preparadas depois.
+    void setQuantizationTileSize(float size) { quantizationTileSize = size; }
+    
+    static constexpr size_t defaultCacheBudget = 256u * 1024u * 1024u;
     
 private:
-    struct RenderData {
-        std::vector<float> vertices;
-        std::vector<float> colors;
-        std::vector<float> thicknesses;
+    // Dados derivados da árvore, calculados uma vez por carregamento.
+    // Os segmentos ficam na pré-ordem da topologia.
+    struct PreparedTree : SegmentData {
+        PreparedTree() = default;
+        ~PreparedTree();
+        PreparedTree(const PreparedTree&) = delete;
+        PreparedTree& operator=(const PreparedTree&) = delete;
+        size_t memoryUsage() const;
+        
+        bool dirty = false;                       // buffers ainda não enviados à GPU
+        
+        // Formato compacto da GPU: (x, y) em int16 relativos ao ladrilho do
+        // segmento e (profundidade, descendentes) em uint16 normalizado. O
+        // ladrilho t cobre os segmentos tileRanges[t], e a posição é
+        // tilePositionScales[4t..4t+1] + tilePositionScales[4t+2..4t+3] * valor.
+        std::vector<int16_t> quantizedVertices;
+        std::vector<uint16_t> quantizedMetrics;
+        std::vector<DrawRange> tileRanges;
+        std::vector<float> tilePositionScales;
+        
+        // Linhas: segmentos seguidos na pré-ordem que continuam um do outro
+        // (polylines e cadeias) formam um GL_LINE_STRIP, e as faixas são
+        // separadas por primitive restart. lineStartIndex[i] é a posição no
+        // buffer de índices do vértice inicial do segmento i; o final vem logo depois.
+        // Os vértices são os pontos da árvore, cada um uma vez: o vértice i é
+        // o fim do segmento i, e o início de um segmento é o fim do pai
+        // (lineStartVertex), salvo nas raízes e onde os pontos não coincidem,
+        // que ganham vértices próprios depois dos segmentCount primeiros.
+        std::vector<int> lineStartIndex;
+        std::vector<int> lineStartVertex;
+        size_t lineVertexCount = 0;
+        size_t lineIndexCount = 0;
+        unsigned int lineVAO = 0, lineVBO = 0, lineEBO = 0;
+        unsigned int quadVAO = 0, instanceVBO = 0;
+        
+        // Nível de detalhe: corte atual da hierarquia de subárvores
+        TreeLOD lod;
+        std::vector<DrawRange> cutRanges;
+        float cutPixelsPerUnit = 0.0f;            // escala para a qual o corte foi escolhido
+        
+        // Recorte pela vista: trechos cujas caixas intersectam a região consultada
+        SegmentBVH bvh;
+        std::vector<DrawRange> visibleRanges;
+        BoundingBox queriedRegion = {0.0f, 0.0f, 0.0f, 0.0f};
+        bool hasQueriedRegion = false;
+        
+        // Interseção dos dois: o que vai para a GPU
+        std::vector<DrawRange> drawRanges;
+        std::vector<const void*> drawLineOffsets;    // em bytes no buffer de índices
+        std::vector<int> drawLineCounts;
+        size_t drawSegmentCount = 0;
+        bool drawInstancesDirty = true;
+        
+        // Trechos desenhados agrupados por ladrilho: uma chamada por grupo,
+        // com o deslocamento e a escala do ladrilho
+        struct TileBatch {
+            size_t tile;
+            size_t firstRange, rangeCount;        // em drawRanges
+            size_t firstInstance, instanceCount;  // no buffer de instâncias desenhado
+        };
+        std::vector<TileBatch> drawTiles;
     };
     
     unsigned int shaderProgram;
-    unsigned int VAO, VBO;
-    float lineWidth;
-    bool useMonochrome;
-    bool gradientMode;
-    bool thicknessMode;
-    bool descendantsColorMode;
-    
-    void calculateNodeInfo(const std::vector<Segment>& segments,
-                          std::vector<int>& depth,
-                          std::vector<int>& descendantCount);
-    int findRootSegment(const std::vector<Segment>& segments);
-    void buildAdjacencyList(const std::vector<Segment>& segments,
-                          std::vector<std::vector<int>>& children);
-    
-    std::vector<Segment> createTestTree();
-    void renderSegments(const std::vector<Segment>& segments);
-    RenderData prepareRenderData(const std::vector<Segment>& segments);
+    unsigned int wideProgram;
+    unsigned int capsuleProgram;
+    unsigned int quadVBO;
+    unsigned int cutQuadVAO, cutInstanceVBO;
+    std::shared_ptr<PreparedTree> tree;
+    LRUCache<std::shared_ptr<PreparedTree>> treeCache;
+    float quantizationTileSize;
+    
+    void prepareTree(SegmentData&& data) override;
+    void quantizeTree(PreparedTree& prepared) const;
+    void uploadRenderData();
+    void setupLineVertexArray(unsigned int vao, unsigned int vertexBuffer, unsigned int indexBuffer);
+    void setupQuadVertexArray(unsigned int vao, unsigned int instanceBuffer, size_t instanceCount);
+    void setupInstanceAttributes(unsigned int instanceBuffer, size_t instanceCount, size_t firstInstance);
+    
+    // Buffer de instâncias em blocos: posições e métricas quantizadas e os
+    // raios em float; cada bloco tem components valores de componentBytes
+    // bytes por segmento
+    struct InstanceBlock {
+        int location;
+        int components;
+        unsigned int type;
+        bool normalized;
+        size_t componentBytes;
+    };
+    static constexpr int instanceBlockCount = 3;
+    static const InstanceBlock instanceBlocks[instanceBlockCount];
+    static void instanceBlockOffsets(size_t instanceCount, size_t* offsets);
+    static void writeInstanceBlocks(const PreparedTree& data, const DrawRange* ranges, size_t rangeCount,
+                                    size_t instanceCount, unsigned int usage);
+    void applyStyleUniforms(unsigned int program);
+    bool updateLevelOfDetail(int viewportWidth, int viewportHeight);
+    bool updateVisibleRegion(int viewportWidth, int viewportHeight);
+    void updateDrawRanges(int viewportWidth, int viewportHeight);
+    void renderSegments(int viewportWidth, int viewportHeight);
     
     unsigned int compileShader(const std::string& source, unsigned int type);
     unsigned int createShaderProgram(const std::string& vertexSource, 
                                     const std::string& fragmentSource);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,168 @@
+#include "TreeTopology.h"
+#include "SegmentTable.h"
+#include "SpatialHash.h"
+#include "ParallelFor.h"
+#include <cmath>
+#include <algorithm>
+
+template <typename Index>
+void BasicTreeTopology<Index>::clear() {
+    parent.clear();
+    childOffsets.clear();
+    childIndices.clear();
+    roots.clear();
+    depth.clear();
+    descendantCount.clear();
+    preorder.clear();
+    chainOffsets.clear();
+    maxDepth = 0;
+    maxDescendants = 0;
+}
+
+template <typename Index>
+template <typename Real>
+void BasicTreeTopology<Index>::build(const BasicSegmentTable<Real, Index>& segments) {
+    clear();
+
+    const Index n = static_cast<Index>(segments.size());
+    if (n == 0) return;
+
+    parent.resize(n);
+    bool hasLinks = false;
+    Span<const Index> parentIndex = segments.parentIndex();
+    for (Index i = 0; i < n; i++) {
+        Index p = parentIndex[i];
+        parent[i] = (p >= 0 && p < n && p != i) ? p : -1;
+        hasLinks |= parent[i] != -1;
+    }
+
+    // Sem conectividade (ex.: árvore de teste): recorre à comparação geométrica
+    if (!hasLinks && n > 1) {
+        linkByGeometry(segments, parent);
+    }
+
+    // Lista de filhos em formato CSR (contagem + prefixo)
+    childOffsets.assign(n + 1, 0);
+    for (Index i = 0; i < n; i++) {
+        if (parent[i] != -1) childOffsets[parent[i] + 1]++;
+        else roots.push_back(i);
+    }
+    for (Index i = 0; i < n; i++) {
+        childOffsets[i + 1] += childOffsets[i];
+    }
+
+    childIndices.resize(childOffsets[n]);
+    std::vector<Index> fill(childOffsets.begin(), childOffsets.end() - 1);
+    for (Index i = 0; i < n; i++) {
+        if (parent[i] != -1) childIndices[fill[parent[i]]++] = i;
+    }
+
+    // Profundidade em BFS a partir de todas as raízes
+    depth.assign(n, -1);
+    std::vector<Index> order;
+    order.reserve(n);
+    for (Index root : roots) {
+        depth[root] = 0;
+        order.push_back(root);
+    }
+
+    for (size_t head = 0; head < order.size(); head++) {
+        Index current = order[head];
+        for (const Index* child = childrenBegin(current); child != childrenEnd(current); ++child) {
+            if (depth[*child] == -1) {
+                depth[*child] = depth[current] + 1;
+                order.push_back(*child);
+            }
+        }
+    }
+
+    // Descendentes acumulados na ordem inversa da BFS (filhos antes dos pais)
+    descendantCount.assign(n, 0);
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        Index p = parent[*it];
+        if (p != -1) descendantCount[p] += 1 + descendantCount[*it];
+    }
+
+    // Pré-ordem (DFS iterativa): a subárvore de preorder[k] ocupa
+    // preorder[k .. k + descendantCount + 1)
+    preorder.reserve(n);
+    std::vector<Index> stack(roots.rbegin(), roots.rend());
+    while (!stack.empty()) {
+        Index current = stack.back();
+        stack.pop_back();
+        preorder.push_back(current);
+        for (const Index* child = childrenEnd(current); child != childrenBegin(current); ) {
+            stack.push_back(*--child);
+        }
+    }
+    
+    // Segmentos em ciclos não são alcançados pela BFS: entram como folhas isoladas
+    for (Index i = 0; i < n; i++) {
+        if (depth[i] < 0) {
+            depth[i] = 0;
+            preorder.push_back(i);
+        }
+    }
+
+    maxDepth = *std::max_element(depth.begin(), depth.end());
+    maxDescendants = *std::max_element(descendantCount.begin(), descendantCount.end());
+
+    buildChains();
+}
+
+template <typename Index>
+void BasicTreeTopology<Index>::buildChains() {
+    // O segmento em k continua a cadeia do anterior quando é filho dele e a
+    // subárvore do anterior é só ele mais a sua (ou seja, filho único)
+    chainOffsets.clear();
+    const size_t n = preorder.size();
+    for (size_t k = 0; k < n; k++) {
+        Index current = preorder[k];
+        bool continues = k > 0 && parent[current] == preorder[k - 1] &&
+                         descendantCount[preorder[k - 1]] == descendantCount[current] + 1;
+        if (!continues) chainOffsets.push_back(static_cast<Index>(k));
+    }
+    chainOffsets.push_back(static_cast<Index>(n));
+}
+
+template <typename Index>
+template <typename Real>
+void BasicTreeTopology<Index>::linkByGeometry(const BasicSegmentTable<Real, Index>& segments,
+                                              std::vector<Index>& parent) {
+    // Apenas para segmentos sem índices de pontos compartilhados: o pai de i
+    // é o primeiro segmento j que termina a menos da tolerância de onde i
+    // começa. Os fins ficam em uma grade com hash, e cada segmento consulta
+    // só as células vizinhas ao seu início, de forma independente.
+    const Real tolerance = Real(0.001f);
+    Span<const Real> startX = segments.startX(), startY = segments.startY();
+    SpatialHashGrid<Real> ends;
+    ends.build(segments.endX(), segments.endY(), tolerance);
+
+    const size_t n = segments.size();
+    unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+    size_t chunkSize = std::max<size_t>(n / (threadCount * 4), 1024);
+    size_t chunkCount = (n + chunkSize - 1) / chunkSize;
+    parallelFor(threadCount, chunkCount, [&](size_t chunk) {
+        size_t end = std::min(n, (chunk + 1) * chunkSize);
+        for (size_t i = chunk * chunkSize; i < end; i++) {
+            int64_t j = ends.findFirst(startX[i], startY[i], static_cast<int64_t>(i));
+            if (j >= 0) parent[i] = static_cast<Index>(j);
+        }
+    });
+}
+
+template <typename Index>
+size_t BasicTreeTopology<Index>::memoryUsage() const {
+    return (parent.capacity() + childOffsets.capacity() + childIndices.capacity() + roots.capacity() +
+            depth.capacity() + descendantCount.capacity() + preorder.capacity() +
+            chainOffsets.capacity()) * sizeof(Index);
+}
+
+template struct BasicTreeTopology<int16_t>;
+template struct BasicTreeTopology<int32_t>;
+template struct BasicTreeTopology<int64_t>;
+
+#define INSTANTIATE_TOPOLOGY_BUILD(Real, Index) \
+    template void BasicTreeTopology<Index>::build(const BasicSegmentTable<Real, Index>& segments);
+TREE_MODEL_TYPES(INSTANTIATE_TOPOLOGY_BUILD)
+#undef INSTANTIATE_TOPOLOGY_BUILD
@@ -0,0 +1,47 @@
+#ifndef TREETOPOLOGY_H
+#define TREETOPOLOGY_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+template <typename Real, typename Index>
+class BasicSegmentTable;
+
+// Relações pai/filho entre segmentos, construídas em tempo linear. Index é a
+// largura dos índices do modelo (ver TREE_MODEL_TYPES em SegmentTable.h).
+template <typename Index>
+struct BasicTreeTopology {
+    std::vector<Index> parent;          // segmento pai (-1 para raízes)
+    std::vector<Index> childOffsets;    // filhos de i: childIndices[childOffsets[i] .. childOffsets[i + 1])
+    std::vector<Index> childIndices;
+    std::vector<Index> roots;
+    std::vector<Index> depth;           // profundidade a partir da raiz (BFS)
+    std::vector<Index> descendantCount; // número de segmentos na subárvore, sem contar o próprio
+    std::vector<Index> preorder;        // ordem em profundidade: cada subárvore é um trecho contíguo
+    // Cadeias: trechos da pré-ordem em que cada segmento, salvo o último, tem
+    // um único filho, logo depois dele (as sequências de nós de grau 2 entre
+    // bifurcações). A cadeia c é preorder[chainOffsets[c] .. chainOffsets[c + 1]).
+    std::vector<Index> chainOffsets;
+    Index maxDepth = 0;
+    Index maxDescendants = 0;
+
+    template <typename Real>
+    void build(const BasicSegmentTable<Real, Index>& segments);
+    void buildChains();                 // a partir de parent, descendantCount e preorder
+    void clear();
+    size_t chainCount() const { return chainOffsets.empty() ? 0 : chainOffsets.size() - 1; }
+
+    size_t size() const { return parent.size(); }
+    size_t memoryUsage() const;
+    const Index* childrenBegin(Index segment) const { return childIndices.data() + childOffsets[segment]; }
+    const Index* childrenEnd(Index segment) const { return childIndices.data() + childOffsets[segment + 1]; }
+
+private:
+    template <typename Real>
+    static void linkByGeometry(const BasicSegmentTable<Real, Index>& segments, std::vector<Index>& parent);
+};
+
+using TreeTopology = BasicTreeTopology<int32_t>;
+
+#endif
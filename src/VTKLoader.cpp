@@ -1,123 +1,470 @@
 #include "VTKLoader.h"
-#include <fstream>
-#include <sstream>
+#include "MappedFile.h"
+#include "ByteSwap.h"
+#include "ArrayDecoding.h"
+#include "SpatialHash.h"
+#include "ParallelFor.h"
 #include <iostream>
+#include <charconv>
+#include <string_view>
 #include <random>
 #include <cmath>
 #include <algorithm>
 #include <queue>
 #include <functional>
+#include <cstring>
+#include <cctype>
+#include <thread>
 
-VTKLoader::VTKLoader() {}
+namespace {
 
-bool VTKLoader::loadFile(const std::string& filename) {
+// Palavras-chave do formato VTK legado não diferenciam maiúsculas
+bool keywordEquals(std::string_view token, std::string_view keyword) {
+    if (token.size() != keyword.size()) return false;
+    for (size_t i = 0; i < token.size(); i++) {
+        char c = token[i];
+        if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+        if (c != keyword[i]) return false;
+    }
+    return true;
+}
+
+// Percorre os bytes do arquivo mapeado sem cópias nem streams
+class VTKScanner {
+public:
+    VTKScanner(const char* data, size_t size) : cur(data), end(data + size) {}
+
+    // Avança até o próximo caractere visível; false no fim do arquivo
+    bool skipBlank() {
+        while (cur < end && isBlank(*cur)) cur++;
+        return cur < end;
+    }
+
+    char peek() const { return *cur; }
+    const char* position() const { return cur; }
+    const char* limit() const { return end; }
+    void seek(const char* position) { cur = position; }
+
+    void skipLine() {
+        while (cur < end && *cur != '\n') cur++;
+        if (cur < end) cur++;
+    }
+
+    // Restante da linha atual, sem consumi-lo
+    std::string_view restOfLine() const {
+        const char* stop = cur;
+        while (stop < end && *stop != '\n') stop++;
+        return std::string_view(cur, static_cast<size_t>(stop - cur));
+    }
+
+    std::string_view token() {
+        skipBlank();
+        const char* start = cur;
+        while (cur < end && !isBlank(*cur)) cur++;
+        return std::string_view(start, static_cast<size_t>(cur - start));
+    }
+
+    // Consome a próxima palavra apenas se ela for a palavra-chave esperada
+    bool acceptKeyword(std::string_view keyword) {
+        const char* saved = cur;
+        if (keywordEquals(token(), keyword)) return true;
+        cur = saved;
+        return false;
+    }
+
+    // Bloco de bytes crus (dados BINARY); nullptr se o arquivo acabar antes
+    const char* block(size_t bytes) {
+        if (static_cast<size_t>(end - cur) < bytes) {
+            cur = end;
+            return nullptr;
+        }
+        const char* start = cur;
+        cur += bytes;
+        return start;
+    }
+
+    // Lê um número com std::from_chars; em caso de falha o cursor fica no token
+    template <typename T>
+    bool number(T& value) {
+        if (!skipBlank()) return false;
+        auto result = std::from_chars(cur, end, value);
+        if (result.ec != std::errc()) return false;
+        cur = result.ptr;
+        return true;
+    }
+
+private:
+    const char* cur;
+    const char* end;
+
+    static bool isBlank(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+};
+
+// Array de raios do VTK legado: entre os arrays de um componente por ponto
+// ou por célula, o primeiro com "radi" no nome, senão o primeiro de todos
+int findRadiusColumn(const AttributeTable& attributes) {
+    int radiusColumn = -1;
+    for (size_t i = 0; i < attributes.size(); i++) {
+        const AttributeTable::Column& column = attributes.column(i);
+        if (column.components != 1 || column.location == AttributeLocation::FieldData) continue;
+        
+        std::string name = column.name;
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (name.find("radi") != std::string::npos) return static_cast<int>(i);
+        if (radiusColumn < 0) radiusColumn = static_cast<int>(i);
+    }
+    return radiusColumn;
+}
+
+// Número opcional no fim de uma linha de cabeçalho (componentes de SCALARS)
+int trailingCount(std::string_view rest, int fallback) {
+    while (!rest.empty() && (rest.front() == ' ' || rest.front() == '\t')) rest.remove_prefix(1);
+    int value = fallback;
+    auto result = std::from_chars(rest.data(), rest.data() + rest.size(), value);
+    return (result.ec == std::errc() && value > 0) ? value : fallback;
+}
+
+} // namespace
+
+std::string TreeModelType::name() const {
+    std::string text = real == RealType::Double ? "double" : "float";
+    switch (index) {
+        case IndexType::Int16: return text + "/int16";
+        case IndexType::Int32: return text + "/int32";
+        case IndexType::Int64: return text + "/int64";
+    }
+    return text;
+}
+
+TreeModel::TreeModel(TreeModelType type) : useSidecar(true), indexOverflow(false), type(type) {}
+
+template <typename Real, typename Index>
+BasicVTKLoader<Real, Index>::BasicVTKLoader()
+    : TreeModel(TreeModelType::of<Real, Index>()), normalizationScale(1) {}
+
+template <typename Real, typename Index>
+bool BasicVTKLoader<Real, Index>::loadFile(const std::string& filename) {
     std::cout << "Carregando: " << filename << std::endl;
     
+    indexOverflow = false;
     segments.clear();
     points.clear();
+    polylines.clear();
+    topology.clear();
+    attributes.clear();
 
-    if (loadRealVTKFile(filename)) {
-        std::cout << "[+] Arquivo VTK carregado: " << segments.size() << " segmentos" << std::endl;
-        return true;
+    MappedFile file;
+    if (file.open(filename)) {
+        // Os arrays de atributo são lidos do arquivo de origem quando pedidos
+        attributes.setSourceFile(filename, file.size());
+        
+        // O cache binário só vale se o conteúdo do .vtk não mudou desde sua gravação
+        uint64_t sourceHash = useSidecar ? hashContent(file.data(), file.size()) : 0;
+        std::string cachePath = useSidecar ? sidecarPath(filename) : std::string();
+        
+        if (useSidecar && loadSidecar(cachePath, file.size(), sourceHash)) {
+            std::cout << "[+] Cache binário carregado: " << segments.size() << " segmentos" << std::endl;
+            return true;
+        }
+        
+        // Um cache recusado pode ter deixado parte da tabela de atributos
+        attributes.clear();
+        attributes.setSourceFile(filename, file.size());
+        
+        // Arquivos VTK XML (.vtp) começam com '<'; os legados, com "# vtk"
+        const char* first = file.data();
+        const char* end = file.data() + file.size();
+        while (first < end && (*first == ' ' || *first == '\n' || *first == '\r' || *first == '\t')) first++;
+        bool xml = first < end && *first == '<';
+        
+        if (xml ? parseVTP(file.data(), file.size()) : parseVTK(file.data(), file.size())) {
+            topology.build(segments);
+            if (useSidecar) saveSidecar(cachePath, file.size(), sourceHash);
+            std::cout << "[+] Arquivo VTK carregado: " << segments.size() << " segmentos ("
+                      << modelType().name() << ")" << std::endl;
+            return true;
+        }
+        
+        // Quem escolheu o modelo tenta de novo com índices mais largos
+        if (indexOverflow) {
+            std::cout << "[!] Arquivo grande demais para índices " << modelType().name() << std::endl;
+            clear();
+            return false;
+        }
     }
     
     std::cout << "[!] Arquivo não encontrado, gerando árvore procedural" << std::endl;
     generateProceduralTree();
+    topology.build(segments);
     std::cout << "[+] Árvore procedural: " << segments.size() << " segmentos" << std::endl;
     
     return true;
 }
 
-bool VTKLoader::loadRealVTKFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        return false;
+template <typename Real, typename Index>
+bool BasicVTKLoader<Real, Index>::parseVTK(const char* data, size_t size) {
+    VTKScanner scanner(data, size);
+    Polylines lines;
+    std::vector<int64_t> lineCells;     // índice da célula de cada polyline (para CELL_DATA)
+    
+    // Cabeçalho: versão, título e formato (ASCII ou BINARY). Em BINARY os
+    // valores são big-endian e vêm logo após a linha de cada bloco.
+    bool binary = false;
+    if (scanner.skipBlank() && scanner.peek() == '#') {
+        scanner.skipLine();
+        scanner.skipLine();
+        binary = scanner.acceptKeyword("BINARY");
     }
-
-    std::string line;
-    std::vector<Point2D> tempPoints;
-    std::vector<std::pair<int, int>> connections;
-    std::vector<float> radii;
-
-    int pointsCount = 0, linesCount = 0;
-    bool inPointsSection = false, inLinesSection = false, inRadiiSection = false;
-
-    while (std::getline(file, line)) {
-        if (line.empty() || line[0] == '#') continue;
-        
-        std::istringstream iss(line);
-        std::string token;
+    long long attributeCount = 0;     // valores por array em CELL_DATA/POINT_DATA
+    AttributeLocation attributeLocation = AttributeLocation::FieldData;
+    long long vertexCells = 0;        // células VERTICES vêm antes das linhas
+    unsigned int threadCount = std::thread::hardware_concurrency();
+    bool parallel = !binary && size >= parallelParseThreshold && threadCount > 1;
+    
+    // Registra um array de atributo que começa na posição atual, sem ler os
+    // valores: em ASCII o bloco vai até a próxima palavra-chave, em BINARY
+    // tem tamanho conhecido. false se o bloco binário não couber no arquivo.
+    auto addColumn = [&](std::string name, AttributeLocation location, int components,
+                         size_t tuples, ValueType type) {
+        AttributeTable::Column column;
+        column.name = std::move(name);
+        column.location = location;
+        column.components = components;
+        column.tupleCount = tuples;
         
-        if (line.find("POINTS") == 0) {
-            iss >> token >> pointsCount >> token;
-            tempPoints.reserve(pointsCount);
-            inPointsSection = true;
-            inLinesSection = inRadiiSection = false;
-            continue;
-        }
-        else if (line.find("LINES") == 0) {
-            iss >> token >> linesCount;
-            int totalValues;
-            iss >> totalValues;
-            connections.reserve(linesCount);
-            inLinesSection = true;
-            inPointsSection = inRadiiSection = false;
-            continue;
-        }
-        else if (line.find("RADIUS") == 0 || line.find("SCALARS") == 0) {
-            inRadiiSection = true;
-            inPointsSection = inLinesSection = false;
-            continue;
+        ArraySource source;
+        source.type = type;
+        source.count = column.valueCount();
+        source.begin = static_cast<uint64_t>(scanner.position() - data);
+        if (binary) {
+            source.encoding = ArraySource::Binary;
+            source.bigEndian = true;
+            size_t typeSize = valueTypeSize(type);
+            if (!typeSize || !scanner.block(column.valueCount() * typeSize)) return false;
+        } else {
+            source.encoding = ArraySource::Text;
+            scanner.seek(findNumericBlockEnd(scanner.position(), scanner.limit()));
         }
-        else if (line.find("LOOKUP_TABLE") == 0) {
+        source.end = static_cast<uint64_t>(scanner.position() - data);
+        
+        column.sources.push_back(source);
+        attributes.add(std::move(column));
+        return true;
+    };
+
+    while (scanner.skipBlank()) {
+        if (scanner.peek() == '#') {
+            scanner.skipLine();
             continue;
         }
 
-        if (inPointsSection && pointsCount > 0) {
-            float x, y, z;
-            if (iss >> x >> y >> z) {
-                tempPoints.emplace_back(x, y);
-                if (--pointsCount == 0) inPointsSection = false;
+        std::string_view keyword = scanner.token();
+
+        if (keywordEquals(keyword, "POINTS")) {
+            long long pointsCount = 0;
+            scanner.number(pointsCount);
+            std::string_view type = scanner.token();
+            scanner.skipLine();
+
+            size_t count = static_cast<size_t>(std::max(0LL, pointsCount));
+            if (count > static_cast<size_t>(std::numeric_limits<Index>::max())) {
+                indexOverflow = true;
+                return false;
+            }
+            points.reserve(count);
+            if (binary) {
+                ValueType valueType = valueTypeFromLegacy(type);
+                size_t typeSize = valueTypeSize(valueType);
+                const char* block = typeSize ? scanner.block(count * 3 * typeSize) : nullptr;
+                if (!block) {
+                    std::cout << "[!] Bloco POINTS binário inválido" << std::endl;
+                    break;
+                }
+                
+                // Converte em trechos que cabem no cache e descarta o z
+                Real xyz[3 * 1024];
+                for (size_t done = 0; done < count; ) {
+                    size_t n = std::min(count - done, sizeof(xyz) / sizeof(xyz[0]) / 3);
+                    convertBinary(valueType, block + done * 3 * typeSize, n * 3, true, xyz);
+                    for (size_t i = 0; i < n; i++) points.emplace_back(xyz[i * 3], xyz[i * 3 + 1]);
+                    done += n;
+                }
+                continue;
+            }
+            
+            if (parallel) {
+                const char* blockEnd = findNumericBlockEnd(scanner.position(), scanner.limit());
+                bool parsed = parseTextParallel<Real>(scanner.position(), blockEnd, threadCount,
+                    [&](size_t total) {
+                        if (total != count * 3) return false;
+                        points.resize(count);
+                        return true;
+                    },
+                    [&](size_t index, Real value) {
+                        size_t component = index % 3;
+                        if (component == 0) points[index / 3].x = value;
+                        else if (component == 1) points[index / 3].y = value;
+                    });
+                if (parsed) {
+                    scanner.seek(blockEnd);
+                    continue;
+                }
+                points.clear();     // bloco fora do padrão: leitura sequencial
+            }
+            
+            for (long long i = 0; i < pointsCount; i++) {
+                Real x, y, z;
+                if (!scanner.number(x) || !scanner.number(y) || !scanner.number(z)) break;
+                points.emplace_back(x, y);
             }
         }
-        else if (inLinesSection && linesCount > 0) {
-            int numPoints;
-            if (iss >> numPoints) {
-                if (numPoints == 2) {
-                    int p1, p2;
-                    if (iss >> p1 >> p2) {
-                        connections.emplace_back(p1, p2);
-                        linesCount--;
-                    }
-                } else {
-                    // Pula polylines
-                    for (int i = 0; i < numPoints; i++) {
-                        int dummy;
-                        iss >> dummy;
+        else if (keywordEquals(keyword, "LINES")) {
+            long long linesCount = 0, totalValues = 0;
+            scanner.number(linesCount);
+            scanner.number(totalValues);
+
+            // Cada célula é uma polyline; as de dois pontos são o caso comum
+            lines.offsets.reserve(static_cast<size_t>(std::max(0LL, linesCount)) + 1);
+            lines.points.reserve(static_cast<size_t>(std::max(0LL, totalValues - linesCount)));
+            lineCells.reserve(static_cast<size_t>(std::max(0LL, linesCount)));
+            if (binary) {
+                scanner.skipLine();
+                size_t valueCount = static_cast<size_t>(std::max(0LL, totalValues));
+                const char* block = scanner.block(valueCount * 4);
+                if (!block) {
+                    std::cout << "[!] Bloco LINES binário inválido" << std::endl;
+                    break;
+                }
+                
+                std::vector<int> cells(valueCount);
+                copyBigEndian32(block, valueCount, cells.data());
+                size_t pos = 0;
+                for (long long i = 0; i < linesCount && pos < valueCount; i++) {
+                    int numPoints = cells[pos++];
+                    if (numPoints < 0 || static_cast<size_t>(numPoints) > valueCount - pos) break;
+                    if (numPoints >= 2) {
+                        lines.add(&cells[pos], static_cast<size_t>(numPoints));
+                        lineCells.push_back(vertexCells + i);
                     }
-                    linesCount--;
+                    pos += static_cast<size_t>(numPoints);
                 }
+                continue;
+            }
+            
+            std::vector<int64_t> ids;
+            for (long long i = 0; i < linesCount; i++) {
+                int numPoints;
+                if (!scanner.number(numPoints) || numPoints < 0 || numPoints > totalValues) break;
+                
+                ids.resize(static_cast<size_t>(numPoints));
+                int read = 0;
+                while (read < numPoints && scanner.number(ids[read])) read++;
+                if (read < numPoints) break;
+                
+                if (numPoints >= 2) {
+                    lines.add(ids.data(), ids.size());
+                    lineCells.push_back(vertexCells + i);
+                }
+            }
+        }
+        else if (keywordEquals(keyword, "SCALARS") || keywordEquals(keyword, "RADIUS")) {
+            // SCALARS nome tipo [componentes]; RADIUS é um raio por valor, sem nome
+            std::string name = "radius";
+            ValueType type = ValueType::Float32;
+            int components = 1;
+            if (keywordEquals(keyword, "SCALARS")) {
+                name = std::string(scanner.token());
+                type = valueTypeFromLegacy(scanner.token());
+                components = trailingCount(scanner.restOfLine(), 1);
+            }
+            scanner.skipLine();
+            if (scanner.acceptKeyword("LOOKUP_TABLE")) scanner.skipLine();
+            
+            size_t tuples = static_cast<size_t>(std::max(0LL, attributeCount));
+            if (!addColumn(name, attributeLocation, components, tuples, type)) {
+                std::cout << "[!] Array SCALARS binário inválido ou de tipo não suportado" << std::endl;
+                break;
             }
         }
-        else if (inRadiiSection) {
-            float radius;
-            while (iss >> radius) {
-                radii.push_back(radius);
+        else if (keywordEquals(keyword, "FIELD")) {
+            // FIELD nome n, seguido de n arrays "nome componentes tuplas tipo";
+            // arrays com uma tupla por ponto ou célula ganham essa associação
+            scanner.token();
+            long long arrayCount = 0;
+            scanner.number(arrayCount);
+            scanner.skipLine();
+            
+            bool ok = true;
+            for (long long i = 0; i < arrayCount && ok; i++) {
+                long long components = 0, tuples = 0;
+                std::string name(scanner.token());
+                scanner.number(components);
+                scanner.number(tuples);
+                ValueType type = valueTypeFromLegacy(scanner.token());
+                scanner.skipLine();
+                
+                AttributeLocation location = (attributeLocation != AttributeLocation::FieldData &&
+                                              tuples == attributeCount)
+                    ? attributeLocation : AttributeLocation::FieldData;
+                ok = components > 0 && tuples >= 0 &&
+                     addColumn(name, location, static_cast<int>(components), static_cast<size_t>(tuples), type);
+            }
+            if (!ok) {
+                std::cout << "[!] Bloco FIELD inválido" << std::endl;
+                break;
             }
         }
+        else if (keywordEquals(keyword, "CELL_DATA") || keywordEquals(keyword, "POINT_DATA")) {
+            scanner.number(attributeCount);
+            scanner.skipLine();
+            attributeLocation = keywordEquals(keyword, "CELL_DATA") ? AttributeLocation::CellData
+                                                                      : AttributeLocation::PointData;
+        }
+        else if (keywordEquals(keyword, "VERTICES") ||
+                 (binary && (keywordEquals(keyword, "POLYGONS") || keywordEquals(keyword, "TRIANGLE_STRIPS")))) {
+            // Células que não são linhas: só a contagem de vértices importa,
+            // pois eles vêm antes das linhas na numeração de CELL_DATA. Em
+            // ASCII as linhas numéricas são puladas pelo laço principal.
+            long long cellCount = 0, totalValues = 0;
+            scanner.number(cellCount);
+            scanner.number(totalValues);
+            scanner.skipLine();
+            if (keywordEquals(keyword, "VERTICES")) vertexCells = std::max(0LL, cellCount);
+            if (binary && !scanner.block(static_cast<size_t>(std::max(0LL, totalValues)) * 4)) break;
+        }
+        else if (binary && (keywordEquals(keyword, "VECTORS") || keywordEquals(keyword, "NORMALS"))) {
+            scanner.token();
+            size_t valueSize = valueTypeSize(valueTypeFromLegacy(scanner.token()));
+            scanner.skipLine();
+            size_t count = static_cast<size_t>(std::max(0LL, attributeCount)) * 3;
+            if (!valueSize || !scanner.block(count * valueSize)) break;
+        }
+        else {
+            // Cabeçalho, DATASET, LOOKUP_TABLE...: ignora a linha
+            scanner.skipLine();
+        }
     }
 
-    file.close();
+    if (lines.overflow) {
+        indexOverflow = true;
+        return false;
+    }
+    return buildSegments(lines, lineCells, findRadiusColumn(attributes), data, size);
+}
 
-    if (tempPoints.empty() || connections.empty()) {
+template <typename Real, typename Index>
+bool BasicVTKLoader<Real, Index>::buildSegments(const Polylines& lines, const std::vector<int64_t>& lineCells,
+                                                int radiusColumn, const char* data, size_t size) {
+    if (points.empty() || lines.size() == 0) {
         return false;
     }
 
-    points = std::move(tempPoints);
     
     // Normalização das coordenadas
-    float minX = points[0].x, maxX = points[0].x;
-    float minY = points[0].y, maxY = points[0].y;
+    Real minX = points[0].x, maxX = points[0].x;
+    Real minY = points[0].y, maxY = points[0].y;
     
     for (const auto& p : points) {
         minX = std::min(minX, p.x);
@@ -126,68 +473,258 @@ bool VTKLoader::loadRealVTKFile(const std::string& filename) {
         maxY = std::max(maxY, p.y);
     }
     
-    float scaleX = 2.0f / (maxX - minX);
-    float scaleY = 2.0f / (maxY - minY);
-    float scale = std::min(scaleX, scaleY) * 0.8f;
+    Real scaleX = Real(2) / (maxX - minX);
+    Real scaleY = Real(2) / (maxY - minY);
+    Real scale = std::min(scaleX, scaleY) * Real(0.8);
     
-    float centerX = (minX + maxX) / 2.0f;
-    float centerY = (minY + maxY) / 2.0f;
+    Real centerX = (minX + maxX) / Real(2);
+    Real centerY = (minY + maxY) / Real(2);
+    normalizationCenter = Point(centerX, centerY);
+    normalizationScale = scale;
     
-    segments.reserve(connections.size());
+    // O array de raios é o único lido agora; os demais ficam para quando
+    // forem pedidos. Só é usado se cobrir todos os pontos (POINT_DATA) ou
+    // todas as células das linhas (CELL_DATA); a escolha é feita aqui, uma
+    // vez, e não por segmento.
+    const std::vector<float>* radius = nullptr;
+    AttributeLocation radiusLocation = AttributeLocation::PointData;
+    if (radiusColumn >= 0 && static_cast<size_t>(radiusColumn) < attributes.size()) {
+        radius = attributes.values(static_cast<size_t>(radiusColumn), data, size);
+        radiusLocation = attributes.column(static_cast<size_t>(radiusColumn)).location;
+    }
     
-    for (const auto& conn : connections) {
-        if (conn.first >= points.size() || conn.second >= points.size()) continue;
-        
-        Segment seg;
-        
-        seg.start.x = (points[conn.first].x - centerX) * scale;
-        seg.start.y = (points[conn.first].y - centerY) * scale;
-        seg.end.x = (points[conn.second].x - centerX) * scale;
-        seg.end.y = (points[conn.second].y - centerY) * scale;
-        
-        if (conn.first < radii.size() && conn.second < radii.size()) {
-            seg.startRadius = radii[conn.first] * scale * 0.5f;
-            seg.endRadius = radii[conn.second] * scale * 0.5f;
-        } else {
-            seg.startRadius = 0.03f;
-            seg.endRadius = 0.01f;
+    if (radius && radiusLocation == AttributeLocation::PointData && radius->size() < points.size()) {
+        radius = nullptr;
+    }
+    if (radius && radiusLocation == AttributeLocation::CellData) {
+        int64_t lastCell = lineCells.empty() ? -1 : *std::max_element(lineCells.begin(), lineCells.end());
+        if (lineCells.size() != lines.size() ||
+            static_cast<size_t>(lastCell + 1) > radius->size()) {
+            radius = nullptr;
         }
-        
-        seg.parentIndex = -1;
-        segments.push_back(seg);
+    }
+    
+    // Polylines com algum índice fora do arquivo são descartadas inteiras
+    polylines.clear();
+    polylines.offsets.reserve(lines.offsets.size());
+    polylines.points.reserve(lines.points.size());
+    std::vector<size_t> sourceLine;      // polyline de origem de cada polyline aceita
+    sourceLine.reserve(lines.size());
+    for (size_t line = 0; line < lines.size(); line++) {
+        const Index* ids = lines.points.data() + lines.offsets[line];
+        size_t count = static_cast<size_t>(lines.offsets[line + 1] - lines.offsets[line]);
+        bool valid = true;
+        for (size_t j = 0; j < count; j++) {
+            valid = valid && ids[j] >= 0 && static_cast<size_t>(ids[j]) < points.size();
+        }
+        if (!valid) continue;
+        polylines.add(ids, count);
+        sourceLine.push_back(line);
+    }
+    
+    // Coordenadas copiadas dos pontos, coluna a coluna, e normalizadas
+    // depois em um único passe sobre cada coluna
+    segments.resize(polylines.segmentCount());
+    Span<Real> startX = segments.startX(), startY = segments.startY();
+    Span<Real> endX = segments.endX(), endY = segments.endY();
+    Span<Real> startRadius = segments.startRadius(), endRadius = segments.endRadius();
+    for (size_t line = 0; line < polylines.size(); line++) {
+        size_t segment = static_cast<size_t>(polylines.firstSegment(line));
+        for (size_t j = polylines.offsets[line]; j + 1 < static_cast<size_t>(polylines.offsets[line + 1]); j++, segment++) {
+            const Point& first = points[polylines.points[j]];
+            const Point& second = points[polylines.points[j + 1]];
+            startX[segment] = first.x;
+            startY[segment] = first.y;
+            endX[segment] = second.x;
+            endY[segment] = second.y;
+        }
+    }
+    segments.normalizePositions(centerX, centerY, scale);
+    
+    if (!radius) {
+        std::fill(startRadius.begin(), startRadius.end(), Real(0.03));
+        std::fill(endRadius.begin(), endRadius.end(), Real(0.01));
+    } else if (radiusLocation == AttributeLocation::PointData) {
+        const float* values = radius->data();
+        const Index* ids = polylines.points.data();
+        for (size_t line = 0; line < polylines.size(); line++) {
+            size_t segment = static_cast<size_t>(polylines.firstSegment(line));
+            for (size_t j = polylines.offsets[line]; j + 1 < static_cast<size_t>(polylines.offsets[line + 1]); j++, segment++) {
+                startRadius[segment] = values[ids[j]] * scale * Real(0.5);
+                endRadius[segment] = values[ids[j + 1]] * scale * Real(0.5);
+            }
+        }
+    } else {
+        // Um raio por célula: todos os segmentos da polyline, nas duas pontas
+        const float* values = radius->data();
+        for (size_t line = 0; line < polylines.size(); line++) {
+            Real value = values[lineCells[sourceLine[line]]] * scale * Real(0.5);
+            std::fill(startRadius.begin() + polylines.firstSegment(line),
+                      startRadius.begin() + polylines.firstSegment(line + 1), value);
+            std::fill(endRadius.begin() + polylines.firstSegment(line),
+                      endRadius.begin() + polylines.firstSegment(line + 1), value);
+        }
+    }
+    
+    linkSegmentsByConnectivity();
+    
+    // Arquivos que repetem os pontos em cada célula não compartilham os
+    // índices das pontas: quem começa onde outra célula termina é soldado
+    // a ela, e a ligação é refeita sobre os índices soldados. A comparação
+    // é exata; o milésimo da unidade normalizada só dimensiona a grade.
+    Real gridCellSize = Real(0.001f) / scale;
+    if (weldDuplicatedEndpoints(gridCellSize)) {
+        linkSegmentsByConnectivity();
     }
     
     return !segments.empty();
 }
 
-void VTKLoader::generateProceduralTree() {
+template <typename Real, typename Index>
+void BasicVTKLoader<Real, Index>::linkSegmentsByConnectivity() {
+    // Tabela ponto -> segmento que termina nele; o pai de um segmento é
+    // o segmento que chega ao seu ponto inicial. Dentro de uma polyline,
+    // é o segmento anterior.
+    std::vector<Index> incomingSegment(points.size(), -1);
+    for (size_t line = 0; line < polylines.size(); line++) {
+        Index segment = polylines.firstSegment(line);
+        for (size_t j = polylines.offsets[line] + 1; j < static_cast<size_t>(polylines.offsets[line + 1]); j++) {
+            incomingSegment[polylines.points[j]] = segment++;
+        }
+    }
+    
+    Span<Index> parentIndex = segments.parentIndex();
+    for (size_t line = 0; line < polylines.size(); line++) {
+        Index segment = polylines.firstSegment(line);
+        for (size_t j = polylines.offsets[line]; j + 1 < static_cast<size_t>(polylines.offsets[line + 1]); j++, segment++) {
+            Index parent = incomingSegment[polylines.points[j]];
+            parentIndex[segment] = (parent != segment) ? parent : -1;
+        }
+    }
+}
+
+template <typename Real, typename Index>
+bool BasicVTKLoader<Real, Index>::weldDuplicatedEndpoints(Real gridCellSize) {
+    // Todos os pontos no mesmo lugar (escala infinita) ou coordenadas inválidas
+    if (!(gridCellSize > Real(0)) || !std::isfinite(gridCellSize)) return false;
+    
+    // Só pontos iniciais de polylines podem não ter segmento chegando; são
+    // os candidatos. Com um só, ele é a raiz da árvore.
+    const size_t n = points.size();
+    std::vector<char> hasIncoming(n, 0);
+    for (size_t line = 0; line < polylines.size(); line++) {
+        for (size_t j = polylines.offsets[line] + 1; j < static_cast<size_t>(polylines.offsets[line + 1]); j++) {
+            hasIncoming[polylines.points[j]] = 1;
+        }
+    }
+    std::vector<Index> starts;
+    std::vector<char> listed(n, 0);
+    for (size_t line = 0; line < polylines.size(); line++) {
+        Index id = polylines.points[polylines.offsets[line]];
+        if (!hasIncoming[id] && !listed[id]) {
+            listed[id] = 1;
+            starts.push_back(id);
+        }
+    }
+    if (starts.size() < 2) return false;
+    
+    // Pontos finais em ordem crescente, com as coordenadas em colunas
+    std::vector<Index> ends;
+    std::vector<Real> endX, endY;
+    for (size_t i = 0; i < n; i++) {
+        if (!hasIncoming[i]) continue;
+        ends.push_back(static_cast<Index>(i));
+        endX.push_back(points[i].x);
+        endY.push_back(points[i].y);
+    }
+    SpatialHashGrid<Real> grid;
+    grid.build(Span<const Real>(endX.data(), endX.size()), Span<const Real>(endY.data(), endY.size()), gridCellSize);
+    
+    // Cada candidato procura, de forma independente, o menor ponto final
+    // exatamente na mesma posição: pontos próximos mas distintos não se unem
+    std::vector<Index> target(starts.size(), -1);
+    unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+    size_t chunkSize = std::max<size_t>(starts.size() / (threadCount * 4), 1024);
+    size_t chunkCount = (starts.size() + chunkSize - 1) / chunkSize;
+    parallelFor(threadCount, chunkCount, [&](size_t chunk) {
+        size_t end = std::min(starts.size(), (chunk + 1) * chunkSize);
+        for (size_t i = chunk * chunkSize; i < end; i++) {
+            const Point& p = points[starts[i]];
+            int64_t found = grid.findEqual(p.x, p.y);
+            if (found >= 0) target[i] = ends[static_cast<size_t>(found)];
+        }
+    });
+    if (std::all_of(target.begin(), target.end(), [](Index t) { return t < 0; })) return false;
+    
+    // Componentes já ligadas pelos índices: uma solda só junta componentes
+    // diferentes, então nunca une pontos que a conectividade já liga nem
+    // fecha ciclos
+    std::vector<Index> component(n);
+    for (size_t i = 0; i < n; i++) component[i] = static_cast<Index>(i);
+    auto componentOf = [&](Index id) {
+        while (component[id] != id) {
+            component[id] = component[component[id]];
+            id = component[id];
+        }
+        return id;
+    };
+    for (size_t line = 0; line < polylines.size(); line++) {
+        for (size_t j = polylines.offsets[line] + 1; j < static_cast<size_t>(polylines.offsets[line + 1]); j++) {
+            component[componentOf(polylines.points[j - 1])] = componentOf(polylines.points[j]);
+        }
+    }
+    
+    std::vector<Index> weld(n, -1);
+    bool welded = false;
+    for (size_t i = 0; i < starts.size(); i++) {
+        if (target[i] < 0) continue;
+        Index a = componentOf(starts[i]), b = componentOf(target[i]);
+        if (a == b) continue;
+        component[a] = b;
+        weld[starts[i]] = target[i];
+        welded = true;
+    }
+    
+    // Os candidatos só aparecem no início das polylines; a tabela de pontos
+    // fica como está, para que os atributos por ponto continuem válidos
+    for (size_t line = 0; line < polylines.size(); line++) {
+        Index& id = polylines.points[polylines.offsets[line]];
+        if (weld[id] >= 0) id = weld[id];
+    }
+    return welded;
+}
+
+template <typename Real, typename Index>
+void BasicVTKLoader<Real, Index>::generateProceduralTree() {
     segments.clear();
     points.clear();
+    polylines.clear();
     
     std::mt19937 rng(42);
     std::uniform_real_distribution<float> dist(-0.05f, 0.05f);
     
     points.emplace_back(0.0f, -0.8f);
     
-    std::function<int(Point2D, Point2D, float, float, int, int)> generateBranch;
+    std::function<int(Point, Point, float, float, int, int)> generateBranch;
     
-    generateBranch = [&](Point2D start, Point2D direction, float length, 
-                         float startRadius, int depth, int parentPointIdx) -> int {
+    generateBranch = [&](Point start, Point direction, float length, 
+                         float startRadius, int depth, int parentSegmentIdx) -> int {
         if (depth <= 0 || length < 0.01f) return -1;
         
-        Point2D end;
+        Point end;
         end.x = start.x + direction.x * length + dist(rng);
         end.y = start.y + direction.y * length + dist(rng);
         
         int endPointIdx = static_cast<int>(points.size());
         points.push_back(end);
         
-        Segment seg;
+        typename SegmentTable::Segment seg;
         seg.start = start;
         seg.end = end;
         seg.startRadius = startRadius;
         seg.endRadius = startRadius * 0.7f;
-        seg.parentIndex = parentPointIdx;
+        seg.parentIndex = parentSegmentIdx;
+        int segmentIdx = static_cast<int>(segments.size());
         segments.push_back(seg);
         
         if (depth > 1) {
@@ -196,33 +733,158 @@ void VTKLoader::generateProceduralTree() {
             for (int i = 0; i < numBranches; i++) {
                 float angle = (i == 0) ? 0.5f : -0.5f;
                 
-                Point2D newDir;
+                Point newDir;
                 newDir.x = direction.x * cos(angle) - direction.y * sin(angle);
                 newDir.y = direction.x * sin(angle) + direction.y * cos(angle);
                 
-                float mag = sqrt(newDir.x * newDir.x + newDir.y * newDir.y);
+                Real mag = sqrt(newDir.x * newDir.x + newDir.y * newDir.y);
                 if (mag > 0) {
                     newDir.x /= mag;
                     newDir.y /= mag;
                 }
                 
                 generateBranch(end, newDir, length * 0.6f, startRadius * 0.7f, 
-                              depth - 1, endPointIdx);
+                              depth - 1, segmentIdx);
             }
         }
         
         return endPointIdx;
     };
     
-    // Gera árvore
-    generateBranch(points[0], Point2D(0.0f, 1.0f), 0.6f, 0.08f, 6, 0);
-    generateBranch(Point2D(0.0f, -0.6f), Point2D(0.8f, 0.4f), 0.3f, 0.04f, 4, 0);
-    generateBranch(Point2D(0.0f, -0.6f), Point2D(-0.8f, 0.4f), 0.3f, 0.04f, 4, 0);
-    generateBranch(Point2D(0.0f, -0.3f), Point2D(0.9f, 0.2f), 0.25f, 0.03f, 3, 0);
-    generateBranch(Point2D(0.0f, -0.3f), Point2D(-0.9f, 0.2f), 0.25f, 0.03f, 3, 0);
+    // Gera árvore (ramos laterais partem do tronco, segmento 0)
+    generateBranch(points[0], Point(0.0f, 1.0f), 0.6f, 0.08f, 6, -1);
+    generateBranch(Point(0.0f, -0.6f), Point(0.8f, 0.4f), 0.3f, 0.04f, 4, 0);
+    generateBranch(Point(0.0f, -0.6f), Point(-0.8f, 0.4f), 0.3f, 0.04f, 4, 0);
+    generateBranch(Point(0.0f, -0.3f), Point(0.9f, 0.2f), 0.25f, 0.03f, 3, 0);
+    generateBranch(Point(0.0f, -0.3f), Point(-0.9f, 0.2f), 0.25f, 0.03f, 3, 0);
 }
 
-void VTKLoader::clear() {
+template <typename Real, typename Index>
+void BasicVTKLoader<Real, Index>::clear() {
     segments.clear();
     points.clear();
-}
\ No newline at end of file
+    polylines.clear();
+    topology.clear();
+    attributes.clear();
+}
+
+template <typename Real, typename Index>
+size_t BasicVTKLoader<Real, Index>::memoryUsage() const {
+    return segments.memoryUsage() +
+           points.capacity() * sizeof(Point) +
+           (polylines.offsets.capacity() + polylines.points.capacity()) * sizeof(Index) +
+           topology.memoryUsage() +
+           attributes.memoryUsage();
+}
+
+#define INSTANTIATE_LOADER(Real, Index) template class BasicVTKLoader<Real, Index>;
+TREE_MODEL_TYPES(INSTANTIATE_LOADER)
+#undef INSTANTIATE_LOADER
+
+bool scanVTKCounts(const char* data, size_t size, TreeFileCounts& counts) {
+    // Mesma sequência de blocos de parseVTK, mas os valores são pulados: em
+    // ASCII até a próxima palavra-chave, em BINARY pelo tamanho conhecido
+    VTKScanner scanner(data, size);
+    bool binary = false;
+    if (scanner.skipBlank() && scanner.peek() == '#') {
+        scanner.skipLine();
+        scanner.skipLine();
+        binary = scanner.acceptKeyword("BINARY");
+    }
+    
+    bool hasPoints = false;
+    while (scanner.skipBlank()) {
+        std::string_view keyword = scanner.token();
+        
+        if (keywordEquals(keyword, "POINTS")) {
+            long long pointsCount = 0;
+            scanner.number(pointsCount);
+            ValueType type = valueTypeFromLegacy(scanner.token());
+            scanner.skipLine();
+            
+            counts.pointCount = static_cast<uint64_t>(std::max(0LL, pointsCount));
+            counts.doublePoints = type == ValueType::Float64;
+            hasPoints = true;
+            size_t typeSize = valueTypeSize(type);
+            if (binary && (!typeSize || !scanner.block(static_cast<size_t>(counts.pointCount) * 3 * typeSize))) return false;
+        }
+        else if (keywordEquals(keyword, "VERTICES") || keywordEquals(keyword, "LINES") ||
+                 keywordEquals(keyword, "POLYGONS") || keywordEquals(keyword, "TRIANGLE_STRIPS")) {
+            long long cellCount = 0, totalValues = 0;
+            scanner.number(cellCount);
+            scanner.number(totalValues);
+            scanner.skipLine();
+            
+            // As linhas são as últimas células que importam para o modelo
+            if (keywordEquals(keyword, "LINES")) {
+                counts.cellCount += static_cast<uint64_t>(std::max(0LL, cellCount));
+                counts.connectivitySize = static_cast<uint64_t>(std::max(0LL, totalValues));
+                return hasPoints;
+            }
+            if (keywordEquals(keyword, "VERTICES")) counts.cellCount += static_cast<uint64_t>(std::max(0LL, cellCount));
+            if (binary && !scanner.block(static_cast<size_t>(std::max(0LL, totalValues)) * 4)) return false;
+        }
+        else {
+            scanner.skipLine();
+        }
+        
+        if (!binary) scanner.seek(findNumericBlockEnd(scanner.position(), scanner.limit()));
+    }
+    return false;
+}
+
+TreeModelType chooseTreeModelType(const TreeFileCounts& counts) {
+    // Offsets das polylines vão até o tamanho da conectividade e os índices
+    // de célula até o número de células; o maior dos três decide a largura
+    uint64_t largest = std::max({counts.pointCount, counts.cellCount, counts.connectivitySize});
+    
+    TreeModelType type;
+    type.real = counts.doublePoints ? RealType::Double : RealType::Float;
+    if (largest < static_cast<uint64_t>(std::numeric_limits<int16_t>::max())) type.index = IndexType::Int16;
+    else if (largest < static_cast<uint64_t>(std::numeric_limits<int32_t>::max())) type.index = IndexType::Int32;
+    else type.index = IndexType::Int64;
+    return type;
+}
+
+std::unique_ptr<TreeModel> createTreeModel(TreeModelType type) {
+    bool useDouble = type.real == RealType::Double;
+    switch (type.index) {
+        case IndexType::Int16:
+            if (useDouble) return std::make_unique<BasicVTKLoader<double, int16_t>>();
+            return std::make_unique<BasicVTKLoader<float, int16_t>>();
+        case IndexType::Int32:
+            if (useDouble) return std::make_unique<BasicVTKLoader<double, int32_t>>();
+            return std::make_unique<BasicVTKLoader<float, int32_t>>();
+        case IndexType::Int64:
+            if (useDouble) return std::make_unique<BasicVTKLoader<double, int64_t>>();
+            return std::make_unique<BasicVTKLoader<float, int64_t>>();
+    }
+    return nullptr;
+}
+
+std::unique_ptr<TreeModel> loadTreeModel(const std::string& filename) {
+    // Arquivos que não abrem (ou sem contagens reconhecíveis) ficam com o
+    // modelo menor: o loader gera a árvore procedural, ou amplia os índices
+    // pelo caminho abaixo
+    TreeFileCounts counts;
+    {
+        MappedFile file;
+        if (file.open(filename)) {
+            const char* first = file.data();
+            const char* end = file.data() + file.size();
+            while (first < end && (*first == ' ' || *first == '\n' || *first == '\r' || *first == '\t')) first++;
+            bool xml = first < end && *first == '<';
+            if (!(xml ? scanVTPCounts(file.data(), file.size(), counts) : scanVTKCounts(file.data(), file.size(), counts))) {
+                counts = TreeFileCounts();
+            }
+        }
+    }
+    
+    TreeModelType type = chooseTreeModelType(counts);
+    while (true) {
+        std::unique_ptr<TreeModel> model = createTreeModel(type);
+        if (model->loadFile(filename)) return model;
+        if (!model->indexOverflowed() || type.index == IndexType::Int64) return nullptr;
+        type.index = type.index == IndexType::Int16 ? IndexType::Int32 : IndexType::Int64;
+    }
+}
@@ -3,38 +3,194 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <limits>
+#include <utility>
+#include <cstdint>
+#include "SegmentTable.h"
+#include "TreeTopology.h"
+#include "AttributeTable.h"
 
-struct Point2D {
-    float x, y;
-    Point2D(float x = 0.0f, float y = 0.0f) : x(x), y(y) {}
+// Células LINES do arquivo no formato CSR: a polyline i ocupa os pontos
+// points[offsets[i]] até points[offsets[i + 1] - 1] e gera um segmento por
+// par de pontos vizinhos, de firstSegment(i) em diante, na mesma ordem
+template <typename Index>
+struct BasicPolylines {
+    std::vector<Index> offsets = {0};     // size() + 1 elementos
+    std::vector<Index> points;            // índices em BasicVTKLoader::getPoints()
+    bool overflow = false;                // mais índices do que Index comporta
+    
+    size_t size() const { return offsets.size() - 1; }
+    size_t segmentCount() const { return points.size() - size(); }
+    Index firstSegment(size_t i) const { return static_cast<Index>(offsets[i] - static_cast<Index>(i)); }
+    
+    // Polylines com menos de dois pontos não têm segmentos e são ignoradas.
+    // Índices que não cabem em Index viram -1 e invalidam a polyline.
+    template <typename Id>
+    void add(const Id* ids, size_t count) {
+        const size_t maxIndex = static_cast<size_t>(std::numeric_limits<Index>::max());
+        if (count < 2) return;
+        if (points.size() + count > maxIndex) {
+            overflow = true;
+            return;
+        }
+        for (size_t i = 0; i < count; i++) {
+            int64_t id = static_cast<int64_t>(ids[i]);
+            points.push_back((id < 0 || static_cast<uint64_t>(id) > maxIndex) ? Index(-1) : static_cast<Index>(id));
+        }
+        offsets.push_back(static_cast<Index>(points.size()));
+    }
+    
+    void clear() {
+        offsets.assign(1, 0);
+        points.clear();
+        overflow = false;
+    }
 };
 
-struct Segment {
-    Point2D start, end;
-    float startRadius, endRadius;
-    int parentIndex;
+// Precisão das coordenadas e largura dos índices de um modelo carregado
+enum class RealType : uint8_t { Float, Double };
+enum class IndexType : uint8_t { Int16, Int32, Int64 };
+
+struct TreeModelType {
+    RealType real = RealType::Float;
+    IndexType index = IndexType::Int32;
     
-    Segment(Point2D s = Point2D(), Point2D e = Point2D(), 
-            float sr = 0.1f, float er = 0.05f, int parent = -1) 
-        : start(s), end(e), startRadius(sr), endRadius(er), parentIndex(parent) {}
+    template <typename Real, typename Index>
+    static TreeModelType of() {
+        TreeModelType type;
+        type.real = sizeof(Real) == sizeof(double) ? RealType::Double : RealType::Float;
+        type.index = sizeof(Index) == 2 ? IndexType::Int16 : sizeof(Index) == 4 ? IndexType::Int32 : IndexType::Int64;
+        return type;
+    }
+    std::string name() const;       // "float/int16"...
+};
+
+// Contagens do cabeçalho do arquivo, lidas sem carregar os dados
+struct TreeFileCounts {
+    uint64_t pointCount = 0;
+    uint64_t cellCount = 0;           // células até a última linha (vértices e linhas)
+    uint64_t connectivitySize = 0;    // índices de pontos das linhas (estimado no .vtp)
+    bool doublePoints = false;        // POINTS em double / Float64
 };
 
-class VTKLoader {
+// Parte do modelo que não depende dos tipos: atributos, configuração do
+// cache binário e a interface usada por quem só guarda ou lista a árvore
+class TreeModel {
 public:
-    VTKLoader();
-    bool loadFile(const std::string& filename);
-    void clear();
+    explicit TreeModel(TreeModelType type);
+    virtual ~TreeModel() = default;
     
-    const std::vector<Segment>& getSegments() const { return segments; }
-    const std::vector<Point2D>& getPoints() const { return points; }
-    bool hasData() const { return !segments.empty(); }
+    virtual bool loadFile(const std::string& filename) = 0;
+    virtual void clear() = 0;
+    virtual bool hasData() const = 0;
+    virtual size_t segmentCount() const = 0;
+    virtual size_t memoryUsage() const = 0;     // bytes ocupados pelos dados carregados
     
+    TreeModelType modelType() const { return type; }
+    // Arrays de atributo do arquivo; só o de raios é lido no carregamento
+    const AttributeTable& getAttributes() const { return attributes; }
+    // O arquivo tem mais pontos ou segmentos do que o Index do modelo comporta
+    bool indexOverflowed() const { return indexOverflow; }
+    
+    // Cache binário (.tp1cache) com a árvore já processada: ao lado de cada
+    // arquivo por padrão, ou em uma pasta própria
+    void setSidecarEnabled(bool enabled) { useSidecar = enabled; }
+    void setSidecarDirectory(const std::string& directory) { sidecarDirectory = directory; }
+
+protected:
+    AttributeTable attributes;
+    bool useSidecar;
+    std::string sidecarDirectory;
+    bool indexOverflow;
+    
+    // Implementados em VTKSidecar.cpp
+    std::string sidecarPath(const std::string& filename) const;
+    static uint64_t hashContent(const char* data, size_t size);
+
 private:
-    std::vector<Segment> segments;
-    std::vector<Point2D> points;
+    TreeModelType type;
+};
+
+template <typename Real, typename Index>
+class BasicVTKLoader : public TreeModel {
+public:
+    using Point = BasicPoint2D<Real>;
+    using Polylines = BasicPolylines<Index>;
+    using SegmentTable = BasicSegmentTable<Real, Index>;
+    using TreeTopology = BasicTreeTopology<Index>;
+    
+    BasicVTKLoader();
+    bool loadFile(const std::string& filename) override;
+    void clear() override;
+    
+    const SegmentTable& getSegments() const { return segments; }
+    const std::vector<Point>& getPoints() const { return points; }
+    // Linhas do arquivo com os índices em getPoints(), vazio na árvore procedural
+    const Polylines& getPolylines() const { return polylines; }
+    const TreeTopology& getTopology() const { return topology; }
+    bool hasData() const override { return !segments.empty(); }
+    size_t segmentCount() const override { return segments.size(); }
+    size_t memoryUsage() const override;
+
+private:
+    SegmentTable segments;
+    std::vector<Point> points;
+    Polylines polylines;
+    TreeTopology topology;
+    Point normalizationCenter;     // segmento = (ponto - centro) * escala
+    Real normalizationScale;
     
     void generateProceduralTree();
-    bool loadRealVTKFile(const std::string& filename);
+    void linkSegmentsByConnectivity();
+    // Troca nas polylines o ponto inicial sem segmento chegando pelo ponto
+    // final de outra componente exatamente na mesma posição. gridCellSize só
+    // agrupa os pontos na grade da busca, não é uma tolerância: pontas que
+    // diferem por arredondamento não são soldadas. Retorna true se algum
+    // índice mudou.
+    bool weldDuplicatedEndpoints(Real gridCellSize);
+    bool parseVTK(const char* data, size_t size);
+    bool parseVTP(const char* data, size_t size);     // implementado em VTPReader.cpp
+    // Normaliza os pontos e cria os segmentos de cada polyline; lineCells[i]
+    // é a célula da polyline i, para raios em CELL_DATA; os raios vêm da
+    // coluna radiusColumn de attributes (-1: raios padrão), lida de
+    // [data, data + size)
+    bool buildSegments(const Polylines& lines, const std::vector<int64_t>& lineCells,
+                       int radiusColumn, const char* data, size_t size);
+    
+    // Implementados em VTKSidecar.cpp
+    bool loadSidecar(const std::string& path, uint64_t sourceSize, uint64_t sourceHash);
+    void saveSidecar(const std::string& path, uint64_t sourceSize, uint64_t sourceHash) const;
 };
 
-#endif
\ No newline at end of file
+using VTKLoader = BasicVTKLoader<float, int32_t>;
+
+// Escolha do modelo em tempo de execução: as contagens do cabeçalho decidem o
+// tipo mais estreito que comporta o arquivo (índices de 16 bits para árvores
+// pequenas, 64 bits acima de 2^31; double se os pontos estão em double)
+bool scanVTKCounts(const char* data, size_t size, TreeFileCounts& counts);
+bool scanVTPCounts(const char* data, size_t size, TreeFileCounts& counts);    // implementado em VTPReader.cpp
+TreeModelType chooseTreeModelType(const TreeFileCounts& counts);
+std::unique_ptr<TreeModel> createTreeModel(TreeModelType type);
+
+// Lê o arquivo com o modelo escolhido pelas contagens; se a conectividade
+// real não couber nos índices estimados, tenta de novo com índices mais largos
+std::unique_ptr<TreeModel> loadTreeModel(const std::string& filename);
+
+// Chama f com o loader concreto do modelo
+template <typename Real, typename F>
+void visitTreeModelIndex(const TreeModel& model, F&& f) {
+    switch (model.modelType().index) {
+        case IndexType::Int16: f(static_cast<const BasicVTKLoader<Real, int16_t>&>(model)); break;
+        case IndexType::Int32: f(static_cast<const BasicVTKLoader<Real, int32_t>&>(model)); break;
+        case IndexType::Int64: f(static_cast<const BasicVTKLoader<Real, int64_t>&>(model)); break;
+    }
+}
+
+template <typename F>
+void visitTreeModel(const TreeModel& model, F&& f) {
+    if (model.modelType().real == RealType::Double) visitTreeModelIndex<double>(model, f);
+    else visitTreeModelIndex<float>(model, f);
+}
+
+#endif
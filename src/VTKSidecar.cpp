@@ -0,0 +1,415 @@
+#include "VTKLoader.h"
+#include "MappedFile.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+namespace fs = std::filesystem;
+
+// Arquivo binário com a árvore já processada, gravado ao lado do .vtk (ou na
+// pasta de cache configurada). Cabeçalho fixo seguido dos arrays em SoA, com
+// os tipos do modelo que o gravou (Real e Index) e cada um completado até um
+// múltiplo de 8 bytes: pontos (x, y), polylines (offsets e índices dos
+// pontos), raios (inicial, final) e pai de cada segmento. As coordenadas dos
+// segmentos são refeitas a partir dos pontos e da normalização, e a
+// TreeTopology a partir dos pais, em tempo linear: nenhum índice lido do
+// cache é usado sem verificação. Um modelo de outros tipos recusa o cache e
+// relê o arquivo. No fim vai o catálogo dos arrays de atributo (nome,
+// associação e posição no arquivo de origem), para que continuem
+// disponíveis sem reler o arquivo. O cabeçalho guarda um hash de tudo o que
+// vem depois dele e termina com um hash dos seus próprios campos, para
+// recusar um cache danificado.
+namespace {
+
+const char sidecarMagic[8] = {'T', 'P', '1', 'T', 'R', 'E', 'E', '\0'};
+const uint32_t sidecarVersion = 7;
+const uint32_t byteOrderMark = 0x01020304u;
+const char* sidecarExtension = ".tp1cache";
+
+struct SidecarHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t sourceSize;
+    uint64_t sourceHash;
+    uint64_t payloadHash;       // hashContent de tudo o que vem depois do cabeçalho
+    uint64_t pointCount;
+    uint64_t segmentCount;
+    uint64_t polylineCount;
+    uint64_t polylinePointCount;
+    double centerX;
+    double centerY;
+    double scale;
+    uint8_t realSize;
+    uint8_t indexSize;
+    uint8_t reserved[6];
+    uint64_t headerHash;        // hashContent dos campos acima
+};
+
+const size_t arrayAlignment = 8;
+
+size_t paddingAfter(size_t bytes) {
+    return (arrayAlignment - bytes % arrayAlignment) % arrayAlignment;
+}
+
+// Percorre os arrays do arquivo mapeado sem copiá-los, verificando o tamanho.
+// O mapeamento começa alinhado à página, o cabeçalho tem múltiplo de 8 bytes
+// e cada array é completado até 8 bytes, então todos ficam alinhados.
+class SidecarReader {
+public:
+    SidecarReader(const char* data, size_t size) : cur(data), end(data + size) {}
+    
+    template <typename T>
+    const T* view(size_t count) {
+        size_t bytes = count * sizeof(T);
+        size_t padded = bytes + paddingAfter(bytes);
+        if (!cur || static_cast<size_t>(end - cur) < padded) {
+            cur = nullptr;
+            return nullptr;
+        }
+        const T* values = reinterpret_cast<const T*>(cur);
+        cur += padded;
+        return values;
+    }
+    
+    template <typename T>
+    bool copy(std::vector<T>& values, size_t count) {
+        const T* source = view<T>(count);
+        if (!source) return false;
+        values.assign(source, source + count);
+        return true;
+    }
+    
+    // Valor avulso do catálogo, sem exigência de alinhamento
+    template <typename T>
+    bool value(T& out) {
+        if (!cur || static_cast<size_t>(end - cur) < sizeof(T)) {
+            cur = nullptr;
+            return false;
+        }
+        std::memcpy(&out, cur, sizeof(T));
+        cur += sizeof(T);
+        return true;
+    }
+    
+    bool text(std::string& out, size_t length) {
+        if (!cur || static_cast<size_t>(end - cur) < length) {
+            cur = nullptr;
+            return false;
+        }
+        out.assign(cur, length);
+        cur += length;
+        return true;
+    }
+    
+    bool atEnd() const { return cur == end; }
+
+private:
+    const char* cur;
+    const char* end;
+};
+
+template <typename T>
+void writeArray(std::ofstream& file, Span<const T> values) {
+    const char zeros[arrayAlignment] = {};
+    size_t bytes = values.size() * sizeof(T);
+    file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(bytes));
+    file.write(zeros, static_cast<std::streamsize>(paddingAfter(bytes)));
+}
+
+template <typename T>
+void writeArray(std::ofstream& file, const std::vector<T>& values) {
+    writeArray(file, Span<const T>(values.data(), values.size()));
+}
+
+template <typename T>
+void writeValue(std::ofstream& file, T value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeCatalog(std::ofstream& file, const AttributeTable& attributes) {
+    writeValue<uint32_t>(file, static_cast<uint32_t>(attributes.size()));
+    for (size_t i = 0; i < attributes.size(); i++) {
+        const AttributeTable::Column& column = attributes.column(i);
+        writeValue<uint32_t>(file, static_cast<uint32_t>(column.name.size()));
+        file.write(column.name.data(), static_cast<std::streamsize>(column.name.size()));
+        writeValue<uint8_t>(file, static_cast<uint8_t>(column.location));
+        writeValue<int32_t>(file, column.components);
+        writeValue<uint64_t>(file, column.tupleCount);
+        writeValue<uint32_t>(file, static_cast<uint32_t>(column.sources.size()));
+        for (const ArraySource& source : column.sources) {
+            writeValue<uint8_t>(file, source.encoding);
+            writeValue<uint8_t>(file, static_cast<uint8_t>(source.type));
+            writeValue<uint8_t>(file, source.headerSize);
+            writeValue<uint8_t>(file, source.bigEndian ? 1 : 0);
+            writeValue<uint64_t>(file, source.begin);
+            writeValue<uint64_t>(file, source.end);
+            writeValue<uint64_t>(file, source.count);
+        }
+    }
+}
+
+bool readCatalog(SidecarReader& reader, AttributeTable& attributes) {
+    uint32_t columnCount = 0;
+    if (!reader.value(columnCount)) return false;
+    for (uint32_t i = 0; i < columnCount; i++) {
+        AttributeTable::Column column;
+        uint32_t nameLength = 0, sourceCount = 0;
+        uint8_t location = 0;
+        int32_t components = 0;
+        uint64_t tupleCount = 0;
+        if (!reader.value(nameLength) || !reader.text(column.name, nameLength) ||
+            !reader.value(location) || !reader.value(components) || !reader.value(tupleCount) ||
+            !reader.value(sourceCount) ||
+            location > static_cast<uint8_t>(AttributeLocation::FieldData) || components < 1) {
+            return false;
+        }
+        column.location = static_cast<AttributeLocation>(location);
+        column.components = components;
+        column.tupleCount = static_cast<size_t>(tupleCount);
+        
+        for (uint32_t j = 0; j < sourceCount; j++) {
+            ArraySource source;
+            uint8_t encoding = 0, type = 0, bigEndian = 0;
+            if (!reader.value(encoding) || !reader.value(type) || !reader.value(source.headerSize) ||
+                !reader.value(bigEndian) || !reader.value(source.begin) || !reader.value(source.end) ||
+                !reader.value(source.count) ||
+                encoding > ArraySource::Base64 || type > static_cast<uint8_t>(ValueType::Float64)) {
+                return false;
+            }
+            source.encoding = static_cast<ArraySource::Encoding>(encoding);
+            source.type = static_cast<ValueType>(type);
+            source.bigEndian = bigEndian != 0;
+            column.sources.push_back(source);
+        }
+        attributes.add(std::move(column));
+    }
+    return true;
+}
+
+} // namespace
+
+std::string TreeModel::sidecarPath(const std::string& filename) const {
+    if (sidecarDirectory.empty()) return filename + sidecarExtension;
+    
+    // Na pasta de cache, o nome inclui a pasta de origem para evitar colisões
+    // entre arquivos de mesmo nome
+    std::string flattened = fs::path(filename).lexically_normal().generic_string();
+    for (char& c : flattened) {
+        if (c == '/' || c == ':') c = '_';
+    }
+    return (fs::path(sidecarDirectory) / (flattened + sidecarExtension)).string();
+}
+
+uint64_t TreeModel::hashContent(const char* data, size_t size) {
+    // Hash de 64 bits lendo 8 bytes por vez; só precisa detectar mudanças no arquivo
+    const uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+    uint64_t hash = 0xCBF29CE484222325ull ^ (size * multiplier);
+    
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ (word * multiplier)) * multiplier;
+        hash ^= hash >> 29;
+    }
+    
+    uint64_t tail = 0;
+    if (size > i) std::memcpy(&tail, data + i, size - i);
+    hash = (hash ^ (tail * multiplier)) * multiplier;
+    
+    hash ^= hash >> 32;
+    hash *= multiplier;
+    hash ^= hash >> 29;
+    return hash;
+}
+
+template <typename Real, typename Index>
+bool BasicVTKLoader<Real, Index>::loadSidecar(const std::string& path, uint64_t sourceSize, uint64_t sourceHash) {
+    MappedFile file;
+    if (!file.open(path) || file.size() < sizeof(SidecarHeader)) return false;
+    
+    SidecarHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, sidecarMagic, sizeof(sidecarMagic)) != 0 ||
+        header.version != sidecarVersion || header.byteOrder != byteOrderMark ||
+        header.headerHash != hashContent(file.data(), offsetof(SidecarHeader, headerHash)) ||
+        header.sourceSize != sourceSize || header.sourceHash != sourceHash ||
+        header.realSize != sizeof(Real) || header.indexSize != sizeof(Index) ||
+        header.payloadHash != hashContent(file.data() + sizeof(header), file.size() - sizeof(header))) {
+        return false;
+    }
+    
+    size_t pointCount = static_cast<size_t>(header.pointCount);
+    size_t segmentCount = static_cast<size_t>(header.segmentCount);
+    size_t polylineCount = static_cast<size_t>(header.polylineCount);
+    size_t polylinePointCount = static_cast<size_t>(header.polylinePointCount);
+    if (segmentCount == 0 || polylinePointCount != segmentCount + polylineCount) return false;
+    
+    SidecarReader reader(file.data() + sizeof(header), file.size() - sizeof(header));
+    const Real* pointX = reader.view<Real>(pointCount);
+    const Real* pointY = reader.view<Real>(pointCount);
+    
+    bool ok = reader.copy(polylines.offsets, polylineCount + 1) &&
+              reader.copy(polylines.points, polylinePointCount);
+    const Real* startRadius = reader.view<Real>(segmentCount);
+    const Real* endRadius = reader.view<Real>(segmentCount);
+    const Index* parentIndex = reader.view<Index>(segmentCount);
+    
+    ok = ok && parentIndex && readCatalog(reader, attributes) && reader.atEnd();
+    if (!ok || polylines.offsets.front() != 0) {
+        polylines.clear();
+        attributes.clear();
+        return false;
+    }
+    
+    points.resize(pointCount);
+    for (size_t i = 0; i < pointCount; i++) {
+        points[i] = Point(pointX[i], pointY[i]);
+    }
+    
+    // Mesmas operações da normalização em buildSegments, para resultados
+    // idênticos (o cabeçalho guarda os valores em double, sem perda para Real)
+    Real centerX = static_cast<Real>(header.centerX);
+    Real centerY = static_cast<Real>(header.centerY);
+    Real scale = static_cast<Real>(header.scale);
+    normalizationCenter = Point(centerX, centerY);
+    normalizationScale = scale;
+    
+    // Cada polyline precisa de pelo menos dois pontos, todos dentro do arquivo,
+    // e cada pai precisa ser -1 ou um segmento. Raios são copiados inteiros.
+    segments.resize(segmentCount);
+    std::memcpy(segments.startRadius().data(), startRadius, segmentCount * sizeof(Real));
+    std::memcpy(segments.endRadius().data(), endRadius, segmentCount * sizeof(Real));
+    Span<Index> parents = segments.parentIndex();
+    for (size_t i = 0; i < segmentCount; i++) {
+        if (parentIndex[i] < -1 || parentIndex[i] >= static_cast<Index>(segmentCount)) {
+            clear();
+            return false;
+        }
+        parents[i] = parentIndex[i];
+    }
+    
+    Span<Real> startX = segments.startX(), startY = segments.startY();
+    Span<Real> endX = segments.endX(), endY = segments.endY();
+    size_t segment = 0;
+    for (size_t line = 0; line < polylineCount; line++) {
+        Index begin = polylines.offsets[line], end = polylines.offsets[line + 1];
+        if (begin < 0 || end - begin < 2 || static_cast<size_t>(end) > polylinePointCount ||
+            static_cast<size_t>(polylines.firstSegment(line)) != segment) {
+            clear();
+            return false;
+        }
+        for (Index j = begin; j < end; j++) {
+            if (polylines.points[j] < 0 || static_cast<size_t>(polylines.points[j]) >= pointCount) {
+                clear();
+                return false;
+            }
+        }
+        
+        for (Index j = begin; j + 1 < end; j++, segment++) {
+            const Point& first = points[polylines.points[j]];
+            const Point& second = points[polylines.points[j + 1]];
+            startX[segment] = first.x;
+            startY[segment] = first.y;
+            endX[segment] = second.x;
+            endY[segment] = second.y;
+        }
+    }
+    if (segment != segmentCount) {
+        clear();
+        return false;
+    }
+    segments.normalizePositions(centerX, centerY, scale);
+    
+    // Mesmos segmentos e pais da leitura original, então a mesma topologia
+    topology.build(segments);
+    return true;
+}
+
+template <typename Real, typename Index>
+void BasicVTKLoader<Real, Index>::saveSidecar(const std::string& path, uint64_t sourceSize, uint64_t sourceHash) const {
+    size_t segmentCount = segments.size();
+    if (segmentCount == 0 || polylines.segmentCount() != segmentCount || topology.size() != segmentCount) return;
+    
+    if (!sidecarDirectory.empty()) {
+        std::error_code error;
+        fs::create_directories(sidecarDirectory, error);
+    }
+    
+    // Grava em um arquivo temporário e renomeia, para que outro processo
+    // nunca mapeie um cache pela metade
+    std::string temporaryPath = path + ".tmp";
+    std::ofstream file(temporaryPath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cout << "[!] Não foi possível gravar o cache binário: " << path << std::endl;
+        return;
+    }
+    
+    SidecarHeader header = {};
+    std::memcpy(header.magic, sidecarMagic, sizeof(sidecarMagic));
+    header.version = sidecarVersion;
+    header.byteOrder = byteOrderMark;
+    header.sourceSize = sourceSize;
+    header.sourceHash = sourceHash;
+    header.pointCount = points.size();
+    header.segmentCount = segmentCount;
+    header.polylineCount = polylines.size();
+    header.polylinePointCount = polylines.points.size();
+    header.centerX = normalizationCenter.x;
+    header.centerY = normalizationCenter.y;
+    header.scale = normalizationScale;
+    header.realSize = sizeof(Real);
+    header.indexSize = sizeof(Index);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    
+    std::vector<Real> column(points.size());
+    for (size_t i = 0; i < points.size(); i++) column[i] = points[i].x;
+    writeArray(file, column);
+    for (size_t i = 0; i < points.size(); i++) column[i] = points[i].y;
+    writeArray(file, column);
+    
+    writeArray(file, polylines.offsets);
+    writeArray(file, polylines.points);
+    
+    writeArray(file, segments.startRadius());
+    writeArray(file, segments.endRadius());
+    writeArray(file, segments.parentIndex());
+    writeCatalog(file, attributes);
+    file.close();
+    
+    // O hash do conteúdo só é conhecido no fim: lido do arquivo já gravado,
+    // e o cabeçalho completo é regravado no início
+    std::error_code error;
+    bool written = static_cast<bool>(file);
+    if (written) {
+        MappedFile payload;
+        written = payload.open(temporaryPath) && payload.size() >= sizeof(header);
+        if (written) {
+            header.payloadHash = hashContent(payload.data() + sizeof(header), payload.size() - sizeof(header));
+        }
+    }
+    if (written) {
+        std::fstream patch(temporaryPath, std::ios::binary | std::ios::in | std::ios::out);
+        header.headerHash = hashContent(reinterpret_cast<const char*>(&header), offsetof(SidecarHeader, headerHash));
+        patch.seekp(0);
+        patch.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        patch.close();
+        written = static_cast<bool>(patch);
+    }
+    if (!written) {
+        fs::remove(temporaryPath, error);
+        return;
+    }
+    fs::rename(temporaryPath, path, error);
+    if (error) fs::remove(temporaryPath, error);
+}
+
+#define INSTANTIATE_SIDECAR(Real, Index) \
+    template bool BasicVTKLoader<Real, Index>::loadSidecar(const std::string&, uint64_t, uint64_t); \
+    template void BasicVTKLoader<Real, Index>::saveSidecar(const std::string&, uint64_t, uint64_t) const;
+TREE_MODEL_TYPES(INSTANTIATE_SIDECAR)
+#undef INSTANTIATE_SIDECAR
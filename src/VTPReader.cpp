@@ -0,0 +1,468 @@
+#include "VTKLoader.h"
+#include "ArrayDecoding.h"
+#include <iostream>
+#include <charconv>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+// Leitor de VTK XML PolyData (.vtp) sem montar a árvore do documento: as tags
+// são lidas em sequência até <AppendedData>, guardando apenas a descrição de
+// cada DataArray. Depois os arrays da geometria (pontos, conectividade e
+// offsets das linhas) são decodificados direto do arquivo mapeado; os de
+// PointData e CellData só são registrados na tabela de atributos.
+namespace {
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        char x = a[i], y = b[i];
+        if (x >= 'A' && x <= 'Z') x = static_cast<char>(x - 'A' + 'a');
+        if (y >= 'A' && y <= 'Z') y = static_cast<char>(y - 'A' + 'a');
+        if (x != y) return false;
+    }
+    return true;
+}
+
+bool containsIgnoreCase(std::string_view text, std::string_view part) {
+    for (size_t i = 0; i + part.size() <= text.size(); i++) {
+        if (equalsIgnoreCase(text.substr(i, part.size()), part)) return true;
+    }
+    return false;
+}
+
+struct XMLTag {
+    std::string_view name;
+    bool closing = false;
+    bool selfClosing = false;
+    std::vector<std::pair<std::string_view, std::string_view>> attributes;
+    const char* contentBegin = nullptr;     // logo após o '>'
+    
+    std::string_view attribute(std::string_view key) const {
+        for (const auto& attr : attributes) {
+            if (attr.first == key) return attr.second;
+        }
+        return std::string_view();
+    }
+    
+    template <typename T>
+    bool numberAttribute(std::string_view key, T& value) const {
+        std::string_view text = attribute(key);
+        if (text.empty()) return false;
+        return std::from_chars(text.data(), text.data() + text.size(), value).ec == std::errc();
+    }
+};
+
+// Percorre as tags do documento; ignora declarações, comentários e texto
+class XMLScanner {
+public:
+    XMLScanner(const char* data, size_t size) : cur(data), end(data + size) {}
+    
+    bool next(XMLTag& tag) {
+        while (true) {
+            cur = static_cast<const char*>(std::memchr(cur, '<', static_cast<size_t>(end - cur)));
+            if (!cur) {
+                cur = end;
+                return false;
+            }
+            cur++;
+            if (cur < end && (*cur == '?' || *cur == '!')) {
+                // <?xml ...?> e <!-- ... -->
+                bool comment = end - cur >= 3 && std::memcmp(cur, "!--", 3) == 0;
+                const char* close = comment ? findText("-->") : findText(">");
+                if (!close) return false;
+                cur = close;
+                continue;
+            }
+            break;
+        }
+        
+        tag = XMLTag();
+        if (cur < end && *cur == '/') {
+            tag.closing = true;
+            cur++;
+        }
+        const char* nameStart = cur;
+        while (cur < end && !isBlank(*cur) && *cur != '/' && *cur != '>') cur++;
+        tag.name = std::string_view(nameStart, static_cast<size_t>(cur - nameStart));
+        
+        while (true) {
+            while (cur < end && isBlank(*cur)) cur++;
+            if (cur >= end) return false;
+            if (*cur == '>') {
+                cur++;
+                break;
+            }
+            if (*cur == '/') {
+                tag.selfClosing = true;
+                cur++;
+                continue;
+            }
+            
+            const char* keyStart = cur;
+            while (cur < end && !isBlank(*cur) && *cur != '=' && *cur != '>' && *cur != '/') cur++;
+            std::string_view key(keyStart, static_cast<size_t>(cur - keyStart));
+            while (cur < end && isBlank(*cur)) cur++;
+            if (cur >= end || *cur != '=') continue;
+            cur++;
+            while (cur < end && isBlank(*cur)) cur++;
+            if (cur >= end || (*cur != '"' && *cur != '\'')) return false;
+            
+            char quote = *cur++;
+            const char* valueStart = cur;
+            while (cur < end && *cur != quote) cur++;
+            if (cur >= end) return false;
+            tag.attributes.emplace_back(key, std::string_view(valueStart, static_cast<size_t>(cur - valueStart)));
+            cur++;
+        }
+        
+        tag.contentBegin = cur;
+        return true;
+    }
+    
+    // Texto até a próxima tag (conteúdo de um DataArray inline)
+    std::string_view textUntilTag() const {
+        const char* stop = static_cast<const char*>(std::memchr(cur, '<', static_cast<size_t>(end - cur)));
+        if (!stop) stop = end;
+        return std::string_view(cur, static_cast<size_t>(stop - cur));
+    }
+
+private:
+    const char* cur;
+    const char* end;
+    
+    const char* findText(std::string_view text) const {
+        std::string_view rest(cur, static_cast<size_t>(end - cur));
+        size_t found = rest.find(text);
+        return found == std::string_view::npos ? nullptr : cur + found + text.size();
+    }
+};
+
+enum class Section { None, PointData, CellData, Points, Lines, Other };
+
+struct DataArrayInfo {
+    Section section = Section::None;
+    std::string_view name;
+    std::string_view type;
+    std::string_view format;
+    int components = 1;
+    size_t offset = 0;          // posição em <AppendedData>
+    std::string_view text;      // conteúdo inline (ascii ou binary)
+};
+
+struct PieceInfo {
+    size_t pointCount = 0;
+    size_t vertexCount = 0;             // células Verts vêm antes das linhas
+    size_t lineCount = 0;
+    size_t cellCount = 0;               // vértices, linhas, faixas e polígonos
+    std::string_view pointScalars;      // atributo Scalars de <PointData>
+    std::string_view cellScalars;
+    std::vector<DataArrayInfo> arrays;
+};
+
+struct FileInfo {
+    bool bigEndian = false;
+    size_t headerSize = 4;              // UInt32 ou UInt64 antes de cada bloco binário
+    bool appendedBase64 = false;
+    const char* appended = nullptr;     // primeiro byte após o '_'
+    const char* end = nullptr;
+};
+
+// Onde estão os count valores do array no arquivo [data, file.end). Nos dados
+// anexados crus o cabeçalho com o tamanho é conferido aqui e fica de fora.
+bool locateDataArray(const DataArrayInfo& array, const FileInfo& file, const char* data, size_t count,
+                     ArraySource& source) {
+    source.type = valueTypeFromXML(array.type);
+    source.count = count;
+    source.bigEndian = file.bigEndian;
+    source.headerSize = static_cast<uint8_t>(file.headerSize);
+    
+    const char* begin = array.text.data();
+    const char* end = begin + array.text.size();
+    if (array.format == "ascii") {
+        source.encoding = ArraySource::Text;
+    } else {
+        size_t elementSize = valueTypeSize(source.type);
+        if (elementSize == 0) return false;
+        size_t expectedBytes = count * elementSize;
+        
+        if (array.format == "binary") {
+            source.encoding = ArraySource::Base64;
+        } else if (array.format == "appended" && file.appended) {
+            if (array.offset > static_cast<size_t>(file.end - file.appended)) return false;
+            begin = file.appended + array.offset;
+            end = file.end;
+            
+            if (file.appendedBase64) {
+                source.encoding = ArraySource::Base64;
+            } else {
+                size_t available = static_cast<size_t>(end - begin);
+                if (available < file.headerSize + expectedBytes) return false;
+                uint64_t byteCount = readBlockHeader(reinterpret_cast<const uint8_t*>(begin), file.headerSize, file.bigEndian);
+                if (byteCount < expectedBytes) return false;
+                source.encoding = ArraySource::Binary;
+                begin += file.headerSize;
+                end = begin + expectedBytes;
+            }
+        } else {
+            return false;
+        }
+    }
+    
+    if (!begin) begin = end = data;     // DataArray vazio
+    source.begin = static_cast<uint64_t>(begin - data);
+    source.end = static_cast<uint64_t>(end - data);
+    return true;
+}
+
+// Lê count valores do array, em qualquer um dos formatos, convertendo para T
+template <typename T>
+bool readDataArray(const DataArrayInfo& array, const FileInfo& file, const char* data, size_t count,
+                   std::vector<T>& out) {
+    ArraySource source;
+    if (!locateDataArray(array, file, data, count, source)) return false;
+    out.resize(count);
+    return readArraySource(data, static_cast<size_t>(file.end - data), source, out.data());
+}
+
+// Array de raios: o indicado por Scalars, senão um com "radi" no nome,
+// senão o primeiro de um componente. Dados de pontos têm preferência.
+const DataArrayInfo* findRadiusArray(const PieceInfo& piece) {
+    for (Section section : {Section::PointData, Section::CellData}) {
+        std::string_view scalars = section == Section::PointData ? piece.pointScalars : piece.cellScalars;
+        const DataArrayInfo* named = nullptr;
+        const DataArrayInfo* single = nullptr;
+        
+        for (const auto& array : piece.arrays) {
+            if (array.section != section) continue;
+            if (!scalars.empty() && array.name == scalars) return &array;
+            if (!named && containsIgnoreCase(array.name, "radi")) named = &array;
+            if (!single && array.components == 1) single = &array;
+        }
+        if (named) return named;
+        if (single) return single;
+    }
+    return nullptr;
+}
+
+const DataArrayInfo* findArray(const PieceInfo& piece, Section section, std::string_view name) {
+    for (const auto& array : piece.arrays) {
+        if (array.section == section && (name.empty() || array.name == name)) return &array;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+bool scanVTPCounts(const char* data, size_t size, TreeFileCounts& counts) {
+    // Só as tags até <AppendedData>: contagens das peças e o tipo dos pontos.
+    // O tamanho da conectividade não está no cabeçalho; vale o mínimo de dois
+    // pontos por linha, e o loader amplia os índices se precisar.
+    XMLScanner scanner(data, size);
+    bool inPoints = false;
+    bool hasPiece = false;
+    
+    XMLTag tag;
+    while (scanner.next(tag)) {
+        if (tag.name == "Piece" && !tag.closing) {
+            uint64_t points = 0, vertices = 0, lines = 0;
+            tag.numberAttribute("NumberOfPoints", points);
+            tag.numberAttribute("NumberOfVerts", vertices);
+            tag.numberAttribute("NumberOfLines", lines);
+            counts.pointCount += points;
+            counts.cellCount += vertices + lines;
+            counts.connectivitySize += lines * 2;
+            hasPiece = true;
+        }
+        else if (tag.name == "Points") {
+            inPoints = !tag.closing && !tag.selfClosing;
+        }
+        else if (tag.name == "DataArray" && !tag.closing && inPoints) {
+            counts.doublePoints = counts.doublePoints || tag.attribute("type") == "Float64";
+        }
+        else if (tag.name == "AppendedData") {
+            break;
+        }
+    }
+    return hasPiece;
+}
+
+template <typename Real, typename Index>
+bool BasicVTKLoader<Real, Index>::parseVTP(const char* data, size_t size) {
+    XMLScanner scanner(data, size);
+    FileInfo file;
+    file.end = data + size;
+    std::vector<PieceInfo> pieces;
+    Section section = Section::None;
+    
+    XMLTag tag;
+    while (scanner.next(tag)) {
+        if (tag.name == "VTKFile" && !tag.closing) {
+            if (tag.attribute("type") != "PolyData") {
+                std::cout << "[!] Arquivo VTK XML não é PolyData: " << tag.attribute("type") << std::endl;
+                return false;
+            }
+            if (!tag.attribute("compressor").empty()) {
+                std::cout << "[!] Arquivo VTK XML comprimido não é suportado" << std::endl;
+                return false;
+            }
+            file.bigEndian = tag.attribute("byte_order") == "BigEndian";
+            file.headerSize = tag.attribute("header_type") == "UInt64" ? 8 : 4;
+        }
+        else if (tag.name == "Piece") {
+            if (tag.closing) continue;
+            pieces.emplace_back();
+            tag.numberAttribute("NumberOfPoints", pieces.back().pointCount);
+            tag.numberAttribute("NumberOfLines", pieces.back().lineCount);
+            
+            PieceInfo& piece = pieces.back();
+            tag.numberAttribute("NumberOfVerts", piece.vertexCount);
+            piece.cellCount = piece.vertexCount + piece.lineCount;
+            for (const char* key : {"NumberOfStrips", "NumberOfPolys"}) {
+                size_t count = 0;
+                if (tag.numberAttribute(key, count)) piece.cellCount += count;
+            }
+        }
+        else if (tag.name == "PointData" || tag.name == "CellData" || tag.name == "Points" ||
+                 tag.name == "Lines" || tag.name == "Verts" || tag.name == "Polys" || tag.name == "Strips" ||
+                 tag.name == "FieldData") {
+            if (tag.closing || tag.selfClosing) {
+                section = Section::None;
+                continue;
+            }
+            if (tag.name == "PointData") section = Section::PointData;
+            else if (tag.name == "CellData") section = Section::CellData;
+            else if (tag.name == "Points") section = Section::Points;
+            else if (tag.name == "Lines") section = Section::Lines;
+            else section = Section::Other;
+            
+            if (!pieces.empty() && section == Section::PointData) pieces.back().pointScalars = tag.attribute("Scalars");
+            if (!pieces.empty() && section == Section::CellData) pieces.back().cellScalars = tag.attribute("Scalars");
+        }
+        else if (tag.name == "DataArray" && !tag.closing) {
+            if (pieces.empty() || section == Section::None || section == Section::Other) continue;
+            
+            DataArrayInfo array;
+            array.section = section;
+            array.name = tag.attribute("Name");
+            array.type = tag.attribute("type");
+            array.format = tag.attribute("format");
+            tag.numberAttribute("NumberOfComponents", array.components);
+            tag.numberAttribute("offset", array.offset);
+            if (!tag.selfClosing) array.text = scanner.textUntilTag();
+            pieces.back().arrays.push_back(array);
+        }
+        else if (tag.name == "AppendedData" && !tag.closing) {
+            // Os dados anexados podem conter qualquer byte: a leitura de tags para aqui
+            file.appendedBase64 = tag.attribute("encoding") == "base64";
+            const char* cur = tag.contentBegin;
+            while (cur < file.end && isBlank(*cur)) cur++;
+            if (cur < file.end && *cur == '_') file.appended = cur + 1;
+            break;
+        }
+    }
+    
+    Polylines lines;
+    std::vector<int64_t> lineCells;
+    size_t cellBase = 0;
+    
+    for (const auto& piece : pieces) {
+        size_t pointBase = points.size();
+        if (pointBase + piece.pointCount > static_cast<size_t>(std::numeric_limits<Index>::max())) {
+            indexOverflow = true;
+            return false;
+        }
+        
+        const DataArrayInfo* pointArray = findArray(piece, Section::Points, std::string_view());
+        std::vector<Real> xyz;
+        if (!pointArray || pointArray->components != 3 ||
+            !readDataArray(*pointArray, file, data, piece.pointCount * 3, xyz)) {
+            std::cout << "[!] Pontos inválidos no arquivo VTK XML" << std::endl;
+            return false;
+        }
+        points.reserve(pointBase + piece.pointCount);
+        for (size_t i = 0; i < piece.pointCount; i++) {
+            points.emplace_back(xyz[i * 3], xyz[i * 3 + 1]);
+        }
+        
+        if (piece.lineCount > 0) {
+            const DataArrayInfo* connectivityArray = findArray(piece, Section::Lines, "connectivity");
+            const DataArrayInfo* offsetsArray = findArray(piece, Section::Lines, "offsets");
+            std::vector<int64_t> offsets, ids;
+            if (!connectivityArray || !offsetsArray ||
+                !readDataArray(*offsetsArray, file, data, piece.lineCount, offsets) ||
+                !readDataArray(*connectivityArray, file, data, static_cast<size_t>(std::max<int64_t>(0, offsets.back())), ids)) {
+                std::cout << "[!] Linhas inválidas no arquivo VTK XML" << std::endl;
+                return false;
+            }
+            
+            // offsets[i] é o fim da célula i em connectivity; cada célula é uma polyline
+            for (int64_t& id : ids) id += static_cast<int64_t>(pointBase);
+            int64_t begin = 0;
+            for (size_t i = 0; i < piece.lineCount; i++) {
+                int64_t cellEnd = offsets[i];
+                if (cellEnd < begin || cellEnd > static_cast<int64_t>(ids.size())) break;
+                if (cellEnd - begin >= 2) {
+                    lines.add(ids.data() + begin, static_cast<size_t>(cellEnd - begin));
+                    lineCells.push_back(static_cast<int64_t>(cellBase + piece.vertexCount + i));
+                }
+                begin = cellEnd;
+            }
+        }
+        cellBase += piece.cellCount;
+    }
+    
+    // Um array de atributo por nome de PointData/CellData da primeira peça,
+    // com um trecho por peça. Arrays que faltam (ou mudam de formato) em
+    // alguma peça ficam de fora, para que os índices de pontos e células
+    // continuem alinhados com a geometria.
+    int radiusColumn = -1;
+    const DataArrayInfo* radiusArray = pieces.empty() ? nullptr : findRadiusArray(pieces.front());
+    if (!pieces.empty()) {
+        for (const auto& first : pieces.front().arrays) {
+            if (first.section != Section::PointData && first.section != Section::CellData) continue;
+            
+            AttributeTable::Column column;
+            column.name = std::string(first.name);
+            column.location = first.section == Section::PointData ? AttributeLocation::PointData
+                                                                   : AttributeLocation::CellData;
+            column.components = std::max(first.components, 1);
+            
+            bool complete = true;
+            for (const auto& piece : pieces) {
+                const DataArrayInfo* array = &first;
+                if (&piece != &pieces.front()) array = findArray(piece, first.section, first.name);
+                
+                size_t tuples = first.section == Section::PointData ? piece.pointCount : piece.cellCount;
+                ArraySource source;
+                if (!array || std::max(array->components, 1) != column.components ||
+                    !locateDataArray(*array, file, data, tuples * static_cast<size_t>(column.components), source)) {
+                    complete = false;
+                    break;
+                }
+                column.sources.push_back(source);
+                column.tupleCount += tuples;
+            }
+            if (!complete) continue;
+            
+            if (&first == radiusArray && column.components == 1) radiusColumn = static_cast<int>(attributes.size());
+            attributes.add(std::move(column));
+        }
+    }
+    
+    if (lines.overflow) {
+        indexOverflow = true;
+        return false;
+    }
+    return buildSegments(lines, lineCells, radiusColumn, data, size);
+}
+
+#define INSTANTIATE_VTP_READER(Real, Index) \
+    template bool BasicVTKLoader<Real, Index>::parseVTP(const char*, size_t);
+TREE_MODEL_TYPES(INSTANTIATE_VTP_READER)
+#undef INSTANTIATE_VTP_READER
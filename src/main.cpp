@@ -4,11 +4,16 @@
 #include <cmath>
 #include <chrono>
 #include <algorithm>
+#include <memory>
 #include <filesystem>  
 #include "glad/glad.h"
 #include "GLFW/glfw3.h"
 #include "VTKLoader.h"
 #include "TreeRenderer.h"
+#include "CpuTreeRenderer.h"
+#include "AsyncTreeLoader.h"
+#include "HeadlessContext.h"
+#include "ImageWriter.h"
 
 using namespace std;
 namespace fs = std::filesystem;  
@@ -37,6 +42,8 @@ struct AppConfig {
     float minScale = 0.1f;
     float maxScale = 5.0f;
     float translationLimit = 2.0f;
+    size_t treeCacheBudget = AsyncTreeLoader::defaultCacheBudget;    // árvores lidas (bytes)
+    size_t gpuCacheBudget = TreeRenderer::defaultCacheBudget;        // árvores preparadas e buffers
 };
 
 struct MouseState {
@@ -45,12 +52,33 @@ struct MouseState {
     double lastY = 0.0;
 };
 
+// Exportação em lote sem janela (--headless)
+struct ExportOptions {
+    bool headless = false;
+    string outputDir = "export";
+    int width = 1200;
+    int height = 800;
+    float scale = 1.0f;
+    float translation[2] = {0.0f, 0.0f};
+    float rotationDegrees = 0.0f;
+    string colorMode = "branco";   // branco, verde, profundidade, descendentes
+    bool thickness = false;
+    bool vessel = false;
+    bool cpu = false;              // rasterização em CPU, sem contexto OpenGL
+    bool deepZoom = false;         // posições quantizadas por ladrilhos pequenos
+};
+
+// Lado dos ladrilhos de quantização com --deep-zoom, nas coordenadas
+// normalizadas da árvore ([-0.8, 0.8]): precisão de ~1e-6 por eixo
+const float deepZoomTileSize = 0.05f;
+
 // =============================================
 // Variáveis Globais
 // =============================================
 
 TreeRenderer treeRenderer;
-VTKLoader vtkLoader;
+AsyncTreeLoader asyncLoader;
+shared_ptr<const TreeModel> currentTree;   // árvore exibida na janela
 vector<string> treeFiles;
 vector<string> treeFileNames;
 size_t currentTreeIndex = 0;
@@ -64,6 +92,7 @@ bool monochromeMode = false;
 bool gradientMode = false;
 bool thicknessMode = false;
 bool descendantsColorMode = false;
+bool vesselMode = false;
 
 float transformMatrix[16] = {
     1.0f, 0.0f, 0.0f, 0.0f,
@@ -84,6 +113,7 @@ void updateSmoothTransform(float deltaTime);
 void resetCamera();
 void printControls();
 void printCurrentTreeInfo();
+void printCacheStats(const char* name, const CacheStats& stats);
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
@@ -94,6 +124,11 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 void processInput(GLFWwindow* window);
 void handleKeyPress(int key);
 void handleTreeNavigation(int direction);
+void updateLoadedTree();
+
+bool parseCommandLine(int argc, char** argv, ExportOptions& options);
+bool applyExportStyle(TreeRenderBackend& renderer, const ExportOptions& options);
+int runHeadlessExport(const ExportOptions& options);
 
 // =============================================
 // Implementação
@@ -120,7 +155,8 @@ void loadTreeFiles() {
             if (!entry.is_regular_file()) continue;
             
             string path = entry.path().string();
-            if (entry.path().extension() != ".vtk") continue;
+            string extension = entry.path().extension().string();
+            if (extension != ".vtk" && extension != ".vtp") continue;
             
             treeFiles.push_back(path);
             
@@ -171,6 +207,31 @@ void printCurrentTreeInfo() {
     cout << "\n=== Árvore Atual ===" << endl;
     cout << "Arquivo: " << treeFileNames[currentTreeIndex] << endl;
     cout << "Índice: " << (currentTreeIndex + 1) << " de " << treeFiles.size() << endl;
+    
+    // Lista os arrays de atributo sem lê-los do arquivo
+    if (currentTree) {
+        cout << "Modelo: " << currentTree->modelType().name() << endl;
+        visitTreeModel(*currentTree, [](const auto& tree) {
+            cout << "Segmentos: " << tree.segmentCount() << " em "
+                 << tree.getTopology().chainCount() << " cadeias" << endl;
+        });
+        const AttributeTable& attributes = currentTree->getAttributes();
+        const char* locations[] = {"ponto", "célula", "campo"};
+        for (size_t i = 0; i < attributes.size(); i++) {
+            const AttributeTable::Column& column = attributes.column(i);
+            cout << "Atributo: " << column.name << " (" << locations[static_cast<int>(column.location)]
+                 << ", " << column.components << " comp., " << column.tupleCount << " tuplas"
+                 << (attributes.isLoaded(i) ? ", lido" : "") << ")" << endl;
+        }
+    }
+    printCacheStats("Cache de leitura", asyncLoader.getCacheStats());
+    printCacheStats("Cache de GPU", treeRenderer.getCacheStats());
+}
+
+void printCacheStats(const char* name, const CacheStats& stats) {
+    cout << name << ": " << stats.hits << " acertos, " << stats.misses << " falhas, "
+         << stats.evictions << " descartes, " << stats.entries << " árvores, "
+         << stats.usedBytes / (1024 * 1024) << " de " << stats.budget / (1024 * 1024) << " MB" << endl;
 }
 
 void updateTransformMatrix() {
@@ -296,6 +357,11 @@ void handleKeyPress(int key) {
             treeRenderer.setThicknessMode(thicknessMode);
             cout << "Espessura adaptativa: " << (thicknessMode ? "ON" : "OFF") << endl;
             break;
+        case GLFW_KEY_V:
+            vesselMode = !vesselMode;
+            treeRenderer.setVesselMode(vesselMode);
+            cout << "Vasos com raio real: " << (vesselMode ? "ON" : "OFF") << endl;
+            break;
         case GLFW_KEY_RIGHT:
             handleTreeNavigation(1);
             break;
@@ -357,10 +423,27 @@ void handleTreeNavigation(int direction) {
         currentTreeIndex = (currentTreeIndex == 0) ? treeFiles.size() - 1 : currentTreeIndex - 1;
     }
     
-    if (vtkLoader.loadFile(treeFiles[currentTreeIndex])) {
-        cout << "\n--- Nova Árvore Carregada ---" << endl;
-        printCurrentTreeInfo();
+    // A leitura acontece na thread de carregamento; a árvore atual continua
+    // na tela até a nova ficar pronta
+    asyncLoader.request(treeFiles, currentTreeIndex);
+}
+
+void updateLoadedTree() {
+    LoadedTree loaded;
+    if (!asyncLoader.takeReady(loaded)) return;
+    
+    if (!loaded.tree) {
+        cerr << "Falha ao carregar " << loaded.path << endl;
+        if (!currentTree) treeRenderer.setTree(SegmentTable(), TreeTopology());
+        return;
     }
+    
+    currentTree = loaded.tree;
+    visitTreeModel(*currentTree, [&](const auto& tree) {
+        treeRenderer.setTree(tree.getSegments(), tree.getTopology(), loaded.cacheKey);
+    });
+    cout << "\n--- Nova Árvore Carregada ---" << endl;
+    printCurrentTreeInfo();
 }
 
 void processInput(GLFWwindow* window) {
@@ -394,17 +477,186 @@ void printControls() {
     cout << "Scroll Mouse - Zoom suave" << endl;
     //cout << "T - Alternar Wireframe" << endl;
     cout << "L - Alternar Linhas Adaptativas" << endl;
+    cout << "V - Alternar Vasos (raio inicial/final de cada segmento)" << endl;
     cout << "C - Alternar Modo de Cor (Branco -> Verde -> Profundidade -> Descendentes)" << endl;
     cout << "SETAS - Navegar entre árvores" << endl;
     cout << "I - Mostrar informação da árvore atual" << endl;
     cout << endl;
 }
 
+// =============================================
+// Exportação sem Janela
+// =============================================
+
+void printUsage(const char* program) {
+    cout << "Uso: " << program << " [--headless [opções]]" << endl;
+    cout << "  --headless            Renderiza todas as árvores em PNG, sem janela" << endl;
+    cout << "  --out <pasta>         Pasta de saída (padrão: export)" << endl;
+    cout << "  --size <L>x<A>        Tamanho da imagem (padrão: 1200x800)" << endl;
+    cout << "  --scale <s>           Zoom da câmera (padrão: 1)" << endl;
+    cout << "  --translate <x> <y>   Translação da câmera" << endl;
+    cout << "  --rotate <graus>      Rotação da câmera" << endl;
+    cout << "  --color <modo>        branco, verde, profundidade ou descendentes" << endl;
+    cout << "  --thickness           Espessura adaptativa" << endl;
+    cout << "  --vessel              Vasos com raio real" << endl;
+    cout << "  --cpu                 Renderiza na CPU, sem OpenGL" << endl;
+    cout << "  --deep-zoom           Posições com precisão para zoom profundo" << endl;
+}
+
+bool parseCommandLine(int argc, char** argv, ExportOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        
+        try {
+            if (arg == "--headless") {
+                options.headless = true;
+            } else if (arg == "--out" && hasValue) {
+                options.outputDir = argv[++i];
+            } else if (arg == "--size" && hasValue) {
+                string size = argv[++i];
+                size_t x = size.find('x');
+                if (x == string::npos) return false;
+                options.width = stoi(size.substr(0, x));
+                options.height = stoi(size.substr(x + 1));
+                if (options.width <= 0 || options.height <= 0) return false;
+            } else if (arg == "--scale" && hasValue) {
+                options.scale = stof(argv[++i]);
+            } else if (arg == "--translate" && i + 2 < argc) {
+                options.translation[0] = stof(argv[++i]);
+                options.translation[1] = stof(argv[++i]);
+            } else if (arg == "--rotate" && hasValue) {
+                options.rotationDegrees = stof(argv[++i]);
+            } else if (arg == "--color" && hasValue) {
+                options.colorMode = argv[++i];
+            } else if (arg == "--thickness") {
+                options.thickness = true;
+            } else if (arg == "--vessel") {
+                options.vessel = true;
+            } else if (arg == "--cpu") {
+                options.cpu = true;
+            } else if (arg == "--deep-zoom") {
+                options.deepZoom = true;
+            } else {
+                return false;
+            }
+        } catch (const exception&) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool applyExportStyle(TreeRenderBackend& renderer, const ExportOptions& options) {
+    const string& mode = options.colorMode;
+    if (mode != "branco" && mode != "verde" && mode != "profundidade" && mode != "descendentes") {
+        cerr << "Modo de cor desconhecido: " << mode << endl;
+        return false;
+    }
+    
+    renderer.setColorMode(mode == "verde");
+    renderer.setGradientMode(mode == "profundidade");
+    renderer.setDescendantsColorMode(mode == "descendentes");
+    renderer.setThicknessMode(options.thickness);
+    renderer.setVesselMode(options.vessel);
+    
+    // Câmera fixa, sem suavização
+    camera.scale = options.scale;
+    camera.rotation = options.rotationDegrees * 3.14159265f / 180.0f;
+    camera.translation[0] = options.translation[0];
+    camera.translation[1] = options.translation[1];
+    updateTransformMatrix();
+    return true;
+}
+
+int runHeadlessExport(const ExportOptions& options) {
+    HeadlessContext context;
+    CpuTreeRenderer cpuRenderer;
+    TreeRenderBackend* renderer = &treeRenderer;
+    
+    if (options.cpu) {
+        cpuRenderer.setViewport(options.width, options.height);
+        cpuRenderer.setClearColor(config.backgroundColor[0], config.backgroundColor[1],
+                                  config.backgroundColor[2]);
+        renderer = &cpuRenderer;
+    } else {
+        if (!context.initialize(options.width, options.height)) {
+            cerr << "Falha ao criar contexto OpenGL sem janela" << endl;
+            return -1;
+        }
+        glClearColor(config.backgroundColor[0], config.backgroundColor[1], 
+                     config.backgroundColor[2], 1.0f);
+        if (options.deepZoom) treeRenderer.setQuantizationTileSize(deepZoomTileSize);
+    }
+    
+    if (!renderer->initialize()) {
+        cerr << "Falha ao iniciar renderização da árvore" << endl;
+        return -1;
+    }
+    
+    if (!applyExportStyle(*renderer, options)) {
+        return -1;
+    }
+    
+    error_code error;
+    fs::create_directories(options.outputDir, error);
+    if (error) {
+        cerr << "Não foi possível criar a pasta " << options.outputDir << ": " << error.message() << endl;
+        return -1;
+    }
+    
+    loadTreeFiles();
+    
+    auto start = chrono::steady_clock::now();
+    size_t exported = 0;
+    vector<uint8_t> pixels;
+    
+    for (const auto& file : treeFiles) {
+        unique_ptr<TreeModel> model = loadTreeModel(file);
+        if (!model) continue;
+        visitTreeModel(*model, [&](const auto& tree) { renderer->setTree(tree.getSegments(), tree.getTopology()); });
+        
+        if (!options.cpu) glClear(GL_COLOR_BUFFER_BIT);
+        renderer->applyTransform(transformMatrix);
+        renderer->render();
+        
+        if (options.cpu) {
+            pixels = cpuRenderer.getImage();
+        } else if (!context.readPixels(pixels)) {
+            cerr << "Falha ao ler imagem de " << file << endl;
+            continue;
+        }
+        
+        string output = (fs::path(options.outputDir) / fs::path(file).stem()).string() + ".png";
+        if (writePNG(output, options.width, options.height, pixels)) {
+            cout << "  [+] " << output << endl;
+            exported++;
+        }
+    }
+    
+    float seconds = chrono::duration<float>(chrono::steady_clock::now() - start).count();
+    cout << "Imagens exportadas: " << exported << " de " << treeFiles.size()
+         << " em " << seconds << " s" << endl;
+    
+    renderer->cleanup();
+    return exported == treeFiles.size() ? 0 : 1;
+}
+
 // =============================================
 // Função Principal
 // =============================================
 
-int main() {
+int main(int argc, char** argv) {
+    ExportOptions exportOptions;
+    if (!parseCommandLine(argc, argv, exportOptions)) {
+        printUsage(argv[0]);
+        return -1;
+    }
+    
+    if (exportOptions.headless) {
+        return runHeadlessExport(exportOptions);
+    }
+    
     // Inicialização GLFW
     if (!glfwInit()) {
         cerr << "Falha ao inicializar GLFW" << endl;
@@ -445,12 +697,14 @@ int main() {
         return -1;
     }
 
-    // Carrega dados
+    // Carrega dados em segundo plano
     loadTreeFiles();
-    if (!treeFiles.empty()) {
-        vtkLoader.loadFile(treeFiles[0]);
-        printCurrentTreeInfo();
-    }
+    asyncLoader.setCacheBudget(config.treeCacheBudget);
+    treeRenderer.setCacheBudget(config.gpuCacheBudget);
+    asyncLoader.start();
+    asyncLoader.request(treeFiles, currentTreeIndex);
+    // Sem arquivos não há leitura a esperar: a árvore de teste fica na tela
+    if (treeFiles.empty()) treeRenderer.setTree(SegmentTable(), TreeTopology());
 
     // Configuração OpenGL
     glClearColor(config.backgroundColor[0], config.backgroundColor[1], 
@@ -474,18 +728,21 @@ int main() {
         if (deltaTime > 0.1f) deltaTime = 0.1f;
         
         // Processamento
+        updateLoadedTree();
         processInput(window);
         updateSmoothTransform(deltaTime);
         
         // Renderização
         glClear(GL_COLOR_BUFFER_BIT);
         treeRenderer.applyTransform(transformMatrix);
-        treeRenderer.render(vtkLoader.getSegments());
+        treeRenderer.render();
         
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
 
+    asyncLoader.stop();
+    treeRenderer.cleanup();
     glfwTerminate();
     cout << "Programa finalizado!" << endl;
     return 0;
@@ -0,0 +1,67 @@
+// Testes da exportação sem janela (make test): desenha a árvore de teste
+// em cada modo com mistura de cores e confere que o alfa lido do
+// framebuffer continua opaco, sem halos nas bordas suavizadas.
+#include "HeadlessContext.h"
+#include "TreeRenderer.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int imageSize = 256;
+
+bool checkOpaque(HeadlessContext& context, TreeRenderer& renderer, const char* name) {
+    glClear(GL_COLOR_BUFFER_BIT);
+    renderer.render();
+    
+    std::vector<uint8_t> pixels;
+    if (!context.readPixels(pixels)) {
+        std::cout << "[FALHA] " << name << ": leitura do framebuffer" << std::endl;
+        return false;
+    }
+    
+    // A árvore precisa ter sido desenhada, senão o teste não diz nada
+    size_t translucent = 0, drawn = 0;
+    for (size_t i = 0; i < pixels.size(); i += 4) {
+        if (pixels[i + 3] != 255) translucent++;
+        if (pixels[i] != 0 || pixels[i + 1] != 0 || pixels[i + 2] != 0) drawn++;
+    }
+    bool ok = translucent == 0 && drawn > 0;
+    std::cout << (ok ? "[OK]   " : "[FALHA] ") << name << ": " << translucent
+              << " pixels com alfa abaixo de 255, " << drawn << " desenhados" << std::endl;
+    return ok;
+}
+
+}
+
+int main() {
+    HeadlessContext context;
+    if (!context.initialize(imageSize, imageSize)) {
+        std::cout << "[FALHA] contexto OpenGL sem janela" << std::endl;
+        return 1;
+    }
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    
+    TreeRenderer renderer;
+    if (!renderer.initialize()) {
+        std::cout << "[FALHA] inicialização do renderizador" << std::endl;
+        return 1;
+    }
+    
+    const float identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+    renderer.applyTransform(identity);
+    renderer.setTree(SegmentTable(), TreeTopology());
+    
+    int failures = 0;
+    renderer.setThicknessMode(true);
+    failures += checkOpaque(context, renderer, "espessura") ? 0 : 1;
+    renderer.setThicknessMode(false);
+    renderer.setVesselMode(true);
+    failures += checkOpaque(context, renderer, "vasos") ? 0 : 1;
+    
+    renderer.cleanup();
+    std::cout << (failures == 0 ? "Todos os testes passaram" : "Testes com falha: " + std::to_string(failures))
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
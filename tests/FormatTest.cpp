@@ -0,0 +1,279 @@
+// Testes dos formatos de entrada (make test): a mesma árvore é gravada em
+// VTK ASCII, em BINARY e em cada leiaute do VTK XML (inline, anexado cru e
+// anexado em base64), e todas as leituras precisam dar os mesmos segmentos,
+// raios e pais que a versão ASCII.
+#include "Base64.h"
+#include "ByteSwap.h"
+#include "VTKLoader.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Árvore pequena com ramificação e uma polyline de três pontos; as
+// coordenadas e os raios são exatos em float, como em double
+const std::vector<float> pointCoords = {0, 0, 0,  0, 1.5f, 0,  -1, 2.25f, 0,  1, 2, 0,
+                                        -1.5f, 3, 0,  -2, 3.5f, 0,  2, 3, 0,  1, 4.75f, 0};
+const std::vector<int32_t> lineCells = {2, 0, 1,  3, 1, 2, 4,  2, 2, 5,  3, 1, 3, 6,  2, 3, 7};
+const int lineCount = 5;
+const std::vector<float> radii = {0.5f, 0.375f, 0.25f, 0.25f, 0.125f, 0.125f, 0.0625f, 0.0625f};
+const size_t pointCount = 8;
+
+// Valores em big-endian, como nos blocos BINARY do VTK legado
+template <typename T>
+void appendBigEndian(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    for (size_t i = 0; i < sizeof(T); i++) out += bytes[sizeof(T) - 1 - i];
+}
+
+template <typename T>
+std::string bigEndianBlock(const std::vector<float>& values) {
+    std::string block;
+    for (float value : values) appendBigEndian<T>(block, static_cast<T>(value));
+    return block + "\n";
+}
+
+std::string legacyASCII() {
+    std::ostringstream out;
+    out << "# vtk DataFile Version 3.0\nformatos\nASCII\nDATASET POLYDATA\n";
+    out << "POINTS " << pointCount << " float\n";
+    for (float value : pointCoords) out << value << " ";
+    out << "\nLINES " << lineCount << " " << lineCells.size() << "\n";
+    for (int32_t value : lineCells) out << value << " ";
+    out << "\nPOINT_DATA " << pointCount << "\nSCALARS raio float\nLOOKUP_TABLE default\n";
+    for (float value : radii) out << value << " ";
+    out << "\n";
+    return out.str();
+}
+
+// BINARY com pontos e raios em float ou double e as células em int32
+std::string legacyBinary(bool doubles, bool fieldData) {
+    const char* type = doubles ? "double" : "float";
+    auto block = [&](const std::vector<float>& values) {
+        return doubles ? bigEndianBlock<double>(values) : bigEndianBlock<float>(values);
+    };
+    std::string out = "# vtk DataFile Version 3.0\nformatos\nBINARY\nDATASET POLYDATA\n";
+    out += "POINTS " + std::to_string(pointCount) + " " + type + "\n" + block(pointCoords);
+    out += "LINES " + std::to_string(lineCount) + " " + std::to_string(lineCells.size()) + "\n";
+    for (int32_t value : lineCells) appendBigEndian<int32_t>(out, value);
+    out += "\nPOINT_DATA " + std::to_string(pointCount) + "\n";
+    if (fieldData) out += "FIELD FieldData 1\nraio 1 " + std::to_string(pointCount) + " " + type + "\n";
+    else out += std::string("SCALARS raio ") + type + "\nLOOKUP_TABLE default\n";
+    return out + block(radii);
+}
+
+// Arrays da mesma árvore para o VTK XML; as linhas vão em connectivity e
+// offsets (o fim de cada célula)
+struct XMLArray {
+    const char* name;
+    const char* type;
+    int components;
+    std::vector<double> values;
+};
+
+std::vector<XMLArray> xmlArrays(const char* indexType) {
+    std::vector<double> points(pointCoords.begin(), pointCoords.end());
+    std::vector<double> connectivity, offsets;
+    for (size_t i = 0; i < lineCells.size(); i += lineCells[i] + 1) {
+        for (int32_t k = 1; k <= lineCells[i]; k++) connectivity.push_back(lineCells[i + k]);
+        offsets.push_back(static_cast<double>(connectivity.size()));
+    }
+    return {{"raio", "Float32", 1, std::vector<double>(radii.begin(), radii.end())},
+            {"Points", "Float32", 3, points},
+            {"connectivity", indexType, 1, connectivity},
+            {"offsets", indexType, 1, offsets}};
+}
+
+template <typename T>
+void appendValue(std::string& out, T value, bool bigEndian) {
+    if (bigEndian) {
+        appendBigEndian<T>(out, value);
+        return;
+    }
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+// Bloco binário de um array: o tamanho em bytes (UInt32 ou UInt64) seguido
+// dos valores, os dois na ordem de bytes do arquivo
+std::string binaryBlock(const XMLArray& array, bool uint64Header, bool bigEndian, std::string* header) {
+    std::string values;
+    for (double value : array.values) {
+        if (std::string(array.type) == "Float32") appendValue<float>(values, static_cast<float>(value), bigEndian);
+        else if (std::string(array.type) == "Int32") appendValue<int32_t>(values, static_cast<int32_t>(value), bigEndian);
+        else appendValue<int64_t>(values, static_cast<int64_t>(value), bigEndian);
+    }
+    std::string size;
+    if (uint64Header) appendValue<uint64_t>(size, values.size(), bigEndian);
+    else appendValue<uint32_t>(size, static_cast<uint32_t>(values.size()), bigEndian);
+    if (header) {
+        *header = size;
+        return values;
+    }
+    return size + values;
+}
+
+std::string encodeBase64(const std::string& bytes) {
+    const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for (size_t i = 0; i < bytes.size(); i += 3) {
+        uint32_t bits = uint32_t(static_cast<uint8_t>(bytes[i])) << 16;
+        if (i + 1 < bytes.size()) bits |= uint32_t(static_cast<uint8_t>(bytes[i + 1])) << 8;
+        if (i + 2 < bytes.size()) bits |= static_cast<uint8_t>(bytes[i + 2]);
+        out += alphabet[(bits >> 18) & 63];
+        out += alphabet[(bits >> 12) & 63];
+        out += i + 1 < bytes.size() ? alphabet[(bits >> 6) & 63] : '=';
+        out += i + 2 < bytes.size() ? alphabet[bits & 63] : '=';
+    }
+    return out;
+}
+
+enum class XMLLayout { Ascii, InlineSeparate, InlineCombined, AppendedRaw, AppendedBase64 };
+
+// Arquivo .vtp com todos os arrays no leiaute pedido. Em InlineSeparate o
+// cabeçalho do bloco é codificado à parte, como o VTK grava; em
+// InlineCombined, junto com os valores
+std::string xmlFile(XMLLayout layout, const char* indexType, bool uint64Header, bool bigEndian) {
+    const char* format = layout == XMLLayout::Ascii ? "ascii"
+                       : (layout == XMLLayout::AppendedRaw || layout == XMLLayout::AppendedBase64) ? "appended"
+                       : "binary";
+    std::string appended;
+    auto dataArray = [&](const XMLArray& array) {
+        std::string out = std::string("<DataArray type=\"") + array.type + "\" Name=\"" + array.name +
+                          "\" NumberOfComponents=\"" + std::to_string(array.components) + "\" format=\"" + format + "\"";
+        if (layout == XMLLayout::AppendedRaw || layout == XMLLayout::AppendedBase64) {
+            out += " offset=\"" + std::to_string(appended.size()) + "\"/>\n";
+            if (layout == XMLLayout::AppendedRaw) {
+                appended += binaryBlock(array, uint64Header, bigEndian, nullptr);
+            } else {
+                std::string header;
+                std::string values = binaryBlock(array, uint64Header, bigEndian, &header);
+                appended += encodeBase64(header) + encodeBase64(values);
+            }
+            return out;
+        }
+        out += ">\n";
+        if (layout == XMLLayout::Ascii) {
+            std::ostringstream text;
+            for (double value : array.values) text << value << " ";
+            out += text.str();
+        } else if (layout == XMLLayout::InlineSeparate) {
+            std::string header;
+            std::string values = binaryBlock(array, uint64Header, bigEndian, &header);
+            out += encodeBase64(header) + encodeBase64(values);
+        } else {
+            out += encodeBase64(binaryBlock(array, uint64Header, bigEndian, nullptr));
+        }
+        return out + "\n</DataArray>\n";
+    };
+    
+    std::vector<XMLArray> arrays = xmlArrays(indexType);
+    std::string out = std::string("<?xml version=\"1.0\"?>\n<VTKFile type=\"PolyData\" version=\"1.0\" byte_order=\"") +
+                      (bigEndian ? "BigEndian" : "LittleEndian") + "\" header_type=\"" +
+                      (uint64Header ? "UInt64" : "UInt32") + "\">\n<PolyData>\n";
+    out += "<Piece NumberOfPoints=\"" + std::to_string(pointCount) + "\" NumberOfVerts=\"0\" NumberOfLines=\"" +
+           std::to_string(lineCount) + "\" NumberOfStrips=\"0\" NumberOfPolys=\"0\">\n";
+    out += "<PointData Scalars=\"raio\">\n" + dataArray(arrays[0]) + "</PointData>\n";
+    out += "<Points>\n" + dataArray(arrays[1]) + "</Points>\n";
+    out += "<Lines>\n" + dataArray(arrays[2]) + dataArray(arrays[3]) + "</Lines>\n";
+    out += "</Piece>\n</PolyData>\n";
+    if (!appended.empty()) {
+        out += std::string("<AppendedData encoding=\"") + (layout == XMLLayout::AppendedRaw ? "raw" : "base64") +
+               "\">\n_" + appended + "\n</AppendedData>\n";
+    }
+    return out + "</VTKFile>\n";
+}
+
+bool load(const std::string& name, const std::string& contents, VTKLoader& loader) {
+    fs::path path = fs::temp_directory_path() / ("tp1_formato_" + name);
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << contents;
+    }
+    loader.setSidecarEnabled(false);
+    bool loaded = loader.loadFile(path.string());
+    fs::remove(path);
+    return loaded;
+}
+
+bool sameSegments(const VTKLoader& a, const VTKLoader& b) {
+    const auto& s = a.getSegments();
+    const auto& t = b.getSegments();
+    if (s.size() != t.size() || s.size() == 0) return false;
+    for (size_t i = 0; i < s.size(); i++) {
+        Segment x = s[i], y = t[i];
+        if (std::memcmp(&x, &y, sizeof(Segment)) != 0) return false;
+    }
+    return a.getTopology().parent == b.getTopology().parent;
+}
+
+}
+
+int main() {
+    // As mensagens de carregamento ficam de fora da saída dos testes
+    std::ostringstream discarded;
+    std::streambuf* console = std::cout.rdbuf(discarded.rdbuf());
+    
+    VTKLoader reference;
+    // Os raios são normalizados junto com as coordenadas: confere a razão
+    // entre o primeiro e o último, que com os raios padrão seria 2
+    const auto& segments = reference.getSegments();
+    bool referenceOk = load("ascii.vtk", legacyASCII(), reference) && segments.size() == 7 &&
+                       std::abs(segments[0].startRadius / segments[6].endRadius - 8) < 1e-4f;
+    
+    struct Layout {
+        const char* name;
+        std::string contents;
+    };
+    std::vector<Layout> layouts = {
+        {"binary_float.vtk", legacyBinary(false, false)},
+        {"binary_double.vtk", legacyBinary(true, false)},
+        {"binary_field.vtk", legacyBinary(false, true)},
+        {"ascii.vtp", xmlFile(XMLLayout::Ascii, "Int64", false, false)},
+        {"inline_separado.vtp", xmlFile(XMLLayout::InlineSeparate, "Int64", false, false)},
+        {"inline_junto.vtp", xmlFile(XMLLayout::InlineCombined, "Int32", false, false)},
+        {"inline_uint64.vtp", xmlFile(XMLLayout::InlineSeparate, "Int32", true, false)},
+        {"appended_raw.vtp", xmlFile(XMLLayout::AppendedRaw, "Int64", false, false)},
+        {"appended_raw_uint64.vtp", xmlFile(XMLLayout::AppendedRaw, "Int32", true, false)},
+        {"appended_raw_bigendian.vtp", xmlFile(XMLLayout::AppendedRaw, "Int64", false, true)},
+        {"appended_base64.vtp", xmlFile(XMLLayout::AppendedBase64, "Int64", false, false)},
+        {"appended_base64_uint64.vtp", xmlFile(XMLLayout::AppendedBase64, "Int32", true, true)},
+    };
+    
+    std::cout.rdbuf(console);
+    std::cout << (referenceOk ? "[OK]   " : "[FALHA] ") << "ascii.vtk" << std::endl;
+    int failures = referenceOk ? 0 : 1;
+    
+    // Cada leiaute é lido com os kernels AVX2 e com os laços escalares
+    for (const Layout& layout : layouts) {
+        for (bool avx2 : {true, false}) {
+            bool active = setByteSwapAVX2(avx2);
+            active = setBase64AVX2(avx2) || active;
+            if (avx2 && !active) continue;
+            std::cout.rdbuf(discarded.rdbuf());
+            VTKLoader loader;
+            bool ok = load(layout.name, layout.contents, loader) && sameSegments(reference, loader);
+            std::cout.rdbuf(console);
+            std::cout << (ok ? "[OK]   " : "[FALHA] ") << layout.name << (avx2 ? " (AVX2)" : " (escalar)")
+                      << std::endl;
+            failures += ok ? 0 : 1;
+        }
+    }
+    setByteSwapAVX2(true);
+    setBase64AVX2(true);
+    
+    std::cout << (failures == 0 ? "Todos os testes passaram" : "Testes com falha: " + std::to_string(failures))
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
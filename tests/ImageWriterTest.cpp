@@ -0,0 +1,242 @@
+// Testes do ImageWriter (make test): grava imagens de vários tipos, lê o PNG
+// de volta com um decodificador mínimo (blocos stored e códigos fixos, os
+// únicos que o writePNG emite) e compara com os pixels RGB originais.
+#include "ImageWriter.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+uint32_t readBigEndian(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+    
+    bool read(int count, uint32_t& value) {
+        value = 0;
+        for (int i = 0; i < count; i++) {
+            if (position / 8 >= size) return false;
+            value |= uint32_t((data[position / 8] >> (position % 8)) & 1) << i;
+            position++;
+        }
+        return true;
+    }
+    
+    void alignToByte() { position = (position + 7) / 8 * 8; }
+    size_t bytePosition() const { return position / 8; }
+    void skipBytes(size_t count) { position += count * 8; }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t position = 0;
+};
+
+// Símbolo de literal/comprimento do código fixo, lido bit a bit
+bool readFixedSymbol(BitReader& bits, int& symbol) {
+    uint32_t code = 0, bit;
+    for (int length = 1; length <= 9; length++) {
+        if (!bits.read(1, bit)) return false;
+        code = (code << 1) | bit;
+        if (length == 7 && code <= 0x17) { symbol = 256 + static_cast<int>(code); return true; }
+        if (length == 8 && code >= 0x30 && code <= 0xBF) { symbol = static_cast<int>(code) - 0x30; return true; }
+        if (length == 8 && code >= 0xC0 && code <= 0xC7) { symbol = 280 + static_cast<int>(code) - 0xC0; return true; }
+        if (length == 9 && code >= 0x190) { symbol = 144 + static_cast<int>(code) - 0x190; return true; }
+    }
+    return false;
+}
+
+bool inflate(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    static const uint16_t lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                            35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                            3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const uint16_t distanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                              257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                              8193, 12289, 16385, 24577};
+    static const uint8_t distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                              7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    
+    BitReader bits(data, size);
+    uint32_t last = 0, type = 0;
+    do {
+        if (!bits.read(1, last) || !bits.read(2, type)) return false;
+        if (type == 0) {
+            bits.alignToByte();
+            size_t p = bits.bytePosition();
+            if (p + 4 > size) return false;
+            size_t length = data[p] | (data[p + 1] << 8);
+            size_t inverse = data[p + 2] | (data[p + 3] << 8);
+            if ((length ^ 0xFFFF) != inverse || p + 4 + length > size) return false;
+            out.insert(out.end(), data + p + 4, data + p + 4 + length);
+            bits.skipBytes(4 + length);
+        } else if (type == 1) {
+            int symbol = -1;
+            while (readFixedSymbol(bits, symbol) && symbol != 256) {
+                if (symbol < 256) {
+                    out.push_back(static_cast<uint8_t>(symbol));
+                    continue;
+                }
+                uint32_t extra, distanceCode;
+                int code = symbol - 257;
+                if (code >= 29 || !bits.read(lengthExtra[code], extra)) return false;
+                size_t length = lengthBase[code] + extra;
+                if (!bits.read(5, distanceCode)) return false;
+                distanceCode = ((distanceCode & 1) << 4) | ((distanceCode & 2) << 2) | (distanceCode & 4) |
+                               ((distanceCode & 8) >> 2) | ((distanceCode & 16) >> 4);
+                if (distanceCode >= 30 || !bits.read(distanceExtra[distanceCode], extra)) return false;
+                size_t distance = distanceBase[distanceCode] + extra;
+                if (distance > out.size()) return false;
+                for (size_t i = 0; i < length; i++) out.push_back(out[out.size() - distance]);
+            }
+            if (symbol != 256) return false;
+        } else {
+            return false;
+        }
+    } while (!last);
+    return true;
+}
+
+bool decodePNG(const std::string& path, int& width, int& height, std::vector<uint8_t>& rgb) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> png((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (png.size() < 8) return false;
+    
+    std::vector<uint8_t> stream;
+    size_t p = 8;
+    bool rgbHeader = false;
+    while (p + 12 <= png.size()) {
+        uint32_t length = readBigEndian(&png[p]);
+        std::string type(png.begin() + p + 4, png.begin() + p + 8);
+        if (p + 12 + length > png.size()) return false;
+        if (type == "IHDR") {
+            width = static_cast<int>(readBigEndian(&png[p + 8]));
+            height = static_cast<int>(readBigEndian(&png[p + 12]));
+            rgbHeader = png[p + 16] == 8 && png[p + 17] == 2;
+        } else if (type == "IDAT") {
+            stream.insert(stream.end(), png.begin() + p + 8, png.begin() + p + 8 + length);
+        }
+        p += 12 + length;
+    }
+    
+    std::vector<uint8_t> raw;
+    if (!rgbHeader || stream.size() < 6 || !inflate(stream.data() + 2, stream.size() - 6, raw)) return false;
+    
+    // Desfaz os filtros de cada linha
+    size_t rowBytes = static_cast<size_t>(width) * 3;
+    if (raw.size() != (rowBytes + 1) * height) return false;
+    rgb.assign(rowBytes * height, 0);
+    for (int y = 0; y < height; y++) {
+        uint8_t filter = raw[y * (rowBytes + 1)];
+        const uint8_t* in = &raw[y * (rowBytes + 1) + 1];
+        uint8_t* row = &rgb[y * rowBytes];
+        const uint8_t* up = y > 0 ? row - rowBytes : nullptr;
+        for (size_t i = 0; i < rowBytes; i++) {
+            int a = i >= 3 ? row[i - 3] : 0;
+            int b = up ? up[i] : 0;
+            int c = (up && i >= 3) ? up[i - 3] : 0;
+            int predicted = 0;
+            if (filter == 1) predicted = a;
+            else if (filter == 2) predicted = b;
+            else if (filter == 3) predicted = (a + b) / 2;
+            else if (filter == 4) {
+                int e = a + b - c;
+                int pa = std::abs(e - a), pb = std::abs(e - b), pc = std::abs(e - c);
+                predicted = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+            } else if (filter != 0) {
+                return false;
+            }
+            row[i] = static_cast<uint8_t>(in[i] + predicted);
+        }
+    }
+    return true;
+}
+
+bool run(const char* name, int width, int height, const std::vector<uint8_t>& rgba) {
+    std::string path = (std::filesystem::temp_directory_path() / (std::string("tp1_") + name + ".png")).string();
+    bool ok = writePNG(path, width, height, rgba);
+    
+    int decodedWidth = 0, decodedHeight = 0;
+    std::vector<uint8_t> rgb;
+    ok = ok && decodePNG(path, decodedWidth, decodedHeight, rgb);
+    ok = ok && decodedWidth == width && decodedHeight == height;
+    for (size_t i = 0; ok && i < static_cast<size_t>(width) * height; i++) {
+        ok = rgb[i * 3] == rgba[i * 4] && rgb[i * 3 + 1] == rgba[i * 4 + 1] && rgb[i * 3 + 2] == rgba[i * 4 + 2];
+    }
+    
+    uintmax_t size = ok ? std::filesystem::file_size(path) : 0;
+    std::filesystem::remove(path);
+    std::cout << (ok ? "[OK]   " : "[FALHA] ") << name << " (" << width << "x" << height << ", "
+              << size << " bytes)" << std::endl;
+    return ok;
+}
+
+}
+
+int main() {
+    std::mt19937 rng(7);
+    int failures = 0;
+    
+    // Fundo uniforme com alguns traços, como as árvores exportadas
+    {
+        int w = 640, h = 480;
+        std::vector<uint8_t> image(static_cast<size_t>(w) * h * 4, 255);
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                uint8_t* p = &image[(static_cast<size_t>(y) * w + x) * 4];
+                bool line = std::abs(x - y) < 3 || std::abs(x + y - 600) < 2;
+                p[0] = line ? 200 : 10;
+                p[1] = line ? static_cast<uint8_t>(x) : 10;
+                p[2] = line ? static_cast<uint8_t>(y) : 30;
+                p[3] = static_cast<uint8_t>(rng());   // o alfa é descartado
+            }
+        }
+        failures += run("cena", w, h, image) ? 0 : 1;
+    }
+    
+    // Gradiente: exercita os filtros Sub, Up, Average e Paeth
+    {
+        int w = 257, h = 129;
+        std::vector<uint8_t> image(static_cast<size_t>(w) * h * 4, 255);
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                uint8_t* p = &image[(static_cast<size_t>(y) * w + x) * 4];
+                p[0] = static_cast<uint8_t>(x);
+                p[1] = static_cast<uint8_t>(y * 2);
+                p[2] = static_cast<uint8_t>(x + y);
+            }
+        }
+        failures += run("gradiente", w, h, image) ? 0 : 1;
+    }
+    
+    // Ruído não comprime: blocos stored, inclusive mais de um
+    {
+        int w = 300, h = 200;
+        std::vector<uint8_t> image(static_cast<size_t>(w) * h * 4);
+        for (auto& value : image) value = static_cast<uint8_t>(rng());
+        failures += run("ruido", w, h, image) ? 0 : 1;
+    }
+    
+    // Dimensões mínimas e linhas longas de um só pixel de altura
+    {
+        std::vector<uint8_t> pixel = {1, 2, 3, 255};
+        failures += run("um_pixel", 1, 1, pixel) ? 0 : 1;
+        
+        int w = 5000;
+        std::vector<uint8_t> row(static_cast<size_t>(w) * 4, 0);
+        for (int x = 0; x < w; x++) row[x * 4] = static_cast<uint8_t>(x / 100);
+        failures += run("linha", w, 1, row) ? 0 : 1;
+    }
+    
+    std::cout << (failures == 0 ? "Todos os testes passaram" : "Testes com falha: " + std::to_string(failures))
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,185 @@
+// Testes dos kernels AVX2 (make test): cada um é comparado com o laço
+// escalar em comprimentos ímpares e com origem e destino desalinhados, para
+// que os restos depois dos blocos de 32 bytes também sejam conferidos.
+#include "Base64.h"
+#include "ByteSwap.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Troca de bytes byte a byte, sem depender de nenhum dos kernels
+std::vector<char> reference(const std::vector<char>& source, size_t offset, size_t count, size_t width) {
+    std::vector<char> out(count * width);
+    for (size_t i = 0; i < count; i++) {
+        for (size_t b = 0; b < width; b++) out[i * width + b] = source[offset + i * width + width - 1 - b];
+    }
+    return out;
+}
+
+std::vector<char> swapped(const std::vector<char>& source, size_t offset, size_t count, size_t width,
+                          size_t destinationOffset) {
+    std::vector<char> buffer(count * width + destinationOffset + 8, 0x11);
+    if (width == 4) copyBigEndian32(source.data() + offset, count, buffer.data() + destinationOffset);
+    else copyBigEndian64(source.data() + offset, count, buffer.data() + destinationOffset);
+    
+    // Nada pode ser escrito depois do último valor
+    for (size_t i = destinationOffset + count * width; i < buffer.size(); i++) {
+        if (buffer[i] != 0x11) return std::vector<char>();
+    }
+    return std::vector<char>(buffer.begin() + destinationOffset, buffer.begin() + destinationOffset + count * width);
+}
+
+bool checkByteSwap(size_t width, bool avx2) {
+    std::mt19937 rng(static_cast<unsigned>(width));
+    std::vector<char> source(200 * width + 16);
+    for (auto& value : source) value = static_cast<char>(rng());
+    
+    for (size_t count = 0; count <= 200; count += (count < 70 ? 1 : 13)) {
+        for (size_t offset = 0; offset < 8; offset++) {
+            std::vector<char> expected = reference(source, offset, count, width);
+            for (size_t destinationOffset : {0, 1, 3, 7}) {
+                if (swapped(source, offset, count, width, destinationOffset) != expected) {
+                    std::cout << "    " << width * 8 << " bits, " << count << " valores, origem +" << offset
+                              << ", destino +" << destinationOffset << (avx2 ? " (AVX2)" : " (escalar)")
+                              << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool runByteSwap(const char* name, size_t width) {
+    bool ok = true;
+    for (bool avx2 : {false, true}) {
+        bool active = setByteSwapAVX2(avx2);
+        if (avx2 && !active) {
+            std::cout << "    sem AVX2 neste processador: só o laço escalar foi testado" << std::endl;
+            break;
+        }
+        ok = checkByteSwap(width, avx2) && ok;
+    }
+    setByteSwapAVX2(true);
+    std::cout << (ok ? "[OK]   " : "[FALHA] ") << name << std::endl;
+    return ok;
+}
+
+
+std::string encodeBase64(const std::vector<uint8_t>& bytes) {
+    std::string out;
+    for (size_t i = 0; i < bytes.size(); i += 3) {
+        uint32_t bits = uint32_t(bytes[i]) << 16;
+        if (i + 1 < bytes.size()) bits |= uint32_t(bytes[i + 1]) << 8;
+        if (i + 2 < bytes.size()) bits |= bytes[i + 2];
+        out += alphabet[(bits >> 18) & 63];
+        out += alphabet[(bits >> 12) & 63];
+        out += i + 1 < bytes.size() ? alphabet[(bits >> 6) & 63] : '=';
+        out += i + 2 < bytes.size() ? alphabet[bits & 63] : '=';
+    }
+    return out;
+}
+
+struct Decoded {
+    std::vector<uint8_t> bytes;
+    size_t consumed = 0;
+    bool overflow = false;      // escreveu além de capacity
+    
+    bool operator==(const Decoded& other) const {
+        return bytes == other.bytes && consumed == other.consumed && !overflow && !other.overflow;
+    }
+};
+
+// Decodifica a partir de offset num buffer próprio, para desalinhar a entrada
+Decoded decode(const std::string& text, size_t offset, size_t capacity) {
+    std::string buffer(offset, 'A');
+    buffer += text;
+    std::vector<uint8_t> output(capacity + 40, 0xEE);
+    
+    Decoded result;
+    size_t written = decodeBase64(buffer.data() + offset, text.size(), output.data(), capacity, &result.consumed);
+    result.bytes.assign(output.begin(), output.begin() + std::min(written, output.size()));
+    
+    // O AVX2 pode sujar a folga entre written e capacity, mas não além
+    for (size_t i = capacity; i < output.size(); i++) result.overflow = result.overflow || output[i] != 0xEE;
+    result.overflow = result.overflow || written > capacity;
+    return result;
+}
+
+// O texto de cada caso é decodificado pelos dois kernels com várias
+// capacidades e desalinhamentos; os dois precisam escrever os mesmos bytes e
+// parar no mesmo caractere
+bool sameDecoding(const std::string& text, size_t expectedBytes, const char* description) {
+    for (size_t capacity : {expectedBytes + 32, expectedBytes, expectedBytes / 2, size_t(0)}) {
+        for (size_t offset = 0; offset < 4; offset++) {
+            setBase64AVX2(false);
+            Decoded scalar = decode(text, offset, capacity);
+            if (!setBase64AVX2(true)) return true;
+            Decoded avx2 = decode(text, offset, capacity);
+            if (!(scalar == avx2)) {
+                std::cout << "    " << description << ": " << text.size() << " caracteres, capacidade " << capacity
+                          << ", entrada +" << offset << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool runBase64() {
+    std::mt19937 rng(64);
+    bool ok = true;
+    bool avx2 = setBase64AVX2(true);
+    for (size_t size = 0; size <= 200 && ok; size += (size < 100 ? 1 : 7)) {
+        std::vector<uint8_t> bytes(size);
+        for (auto& value : bytes) value = static_cast<uint8_t>(rng());
+        std::string text = encodeBase64(bytes);
+        
+        // O escalar é a referência: confere o resultado antes de comparar
+        setBase64AVX2(false);
+        Decoded scalar = decode(text, 0, size + 32);
+        ok = scalar.bytes == bytes && !scalar.overflow;
+        setBase64AVX2(avx2);
+        
+        // Quebras de linha e espaços no meio, um caractere inválido e dois
+        // blocos separados pelo '=', como nos arrays do VTK
+        std::string wrapped;
+        for (size_t i = 0; i < text.size(); i++) {
+            if (i % 76 == 75) wrapped += "\n";
+            if (i % 45 == 44) wrapped += "  \t";
+            wrapped += text[i];
+        }
+        std::string invalid = text;
+        if (!invalid.empty()) invalid[rng() % invalid.size()] = '*';
+        
+        ok = ok && sameDecoding(text, size, "texto contínuo") && sameDecoding(wrapped, size, "com brancos") &&
+             sameDecoding(invalid, size, "caractere inválido") &&
+             sameDecoding(text + encodeBase64(bytes), size * 2, "dois blocos");
+        if (!ok) std::cout << "    " << size << " bytes" << std::endl;
+    }
+    setBase64AVX2(true);
+    if (!avx2) std::cout << "    sem AVX2 neste processador: só o laço escalar foi testado" << std::endl;
+    std::cout << (ok ? "[OK]   " : "[FALHA] ") << "base64" << std::endl;
+    return ok;
+}
+
+}
+
+int main() {
+    int failures = 0;
+    failures += runByteSwap("troca_32_bits", 4) ? 0 : 1;
+    failures += runByteSwap("troca_64_bits", 8) ? 0 : 1;
+    failures += runBase64() ? 0 : 1;
+    
+    std::cout << (failures == 0 ? "Todos os testes passaram" : "Testes com falha: " + std::to_string(failures))
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,264 @@
+// Testes da leitura paralela de texto (make test): parseTextParallel corta
+// o bloco no meio das linhas e avança cada corte até o fim da linha; com
+// vários números de threads os cortes caem em pontos diferentes, e o
+// resultado precisa ser o mesmo da leitura sequencial. Também confere os
+// blocos logo abaixo e logo acima de parallelParseThreshold e arquivos
+// inteiros nos dois lados do limite, contra a mesma árvore em BINARY.
+#include "ArrayDecoding.h"
+#include "VTKLoader.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string formatFloat(float value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.9g", value);
+    return text;
+}
+
+std::vector<float> randomValues(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> distribution(-1000.0f, 1000.0f);
+    std::vector<float> values(count);
+    for (auto& value : values) value = distribution(rng);
+    return values;
+}
+
+// Valores em linhas de 1 a perLine números, com o separador e o fim de
+// linha pedidos
+std::string textBlock(const std::vector<float>& values, size_t perLine, const char* separator,
+                      const char* newline) {
+    std::string text;
+    for (size_t i = 0; i < values.size(); i++) {
+        text += formatFloat(values[i]);
+        bool lineEnd = (i % perLine == perLine - 1) || i + 1 == values.size();
+        text += lineEnd ? newline : separator;
+    }
+    return text;
+}
+
+bool parseSequential(const std::string& text, std::vector<float>& values) {
+    values.clear();
+    const char* cur = text.data();
+    const char* end = cur + text.size();
+    float value;
+    while (parseTextValue(cur, end, value)) values.push_back(value);
+    while (cur < end && static_cast<unsigned char>(*cur) <= ' ') cur++;
+    return cur == end;
+}
+
+bool parseParallel(const std::string& text, unsigned int threadCount, std::vector<float>& values) {
+    values.clear();
+    return parseTextParallel<float>(text.data(), text.data() + text.size(), threadCount,
+        [&](size_t total) {
+            values.resize(total);
+            return true;
+        },
+        [&](size_t index, float value) { values[index] = value; });
+}
+
+// Compara com a leitura sequencial para 2 a 17 threads; valid diz se o
+// bloco é todo numérico (senão a leitura paralela precisa recusá-lo)
+bool checkBlock(const char* name, const std::string& text, bool valid) {
+    std::vector<float> sequential, parallel;
+    bool ok = parseSequential(text, sequential) == valid;
+    for (unsigned int threads = 2; threads <= 17 && ok; threads++) {
+        bool parsed = parseParallel(text, threads, parallel);
+        ok = valid ? (parsed && parallel == sequential) : !parsed;
+        if (!ok) std::cout << "    " << threads << " threads" << std::endl;
+    }
+    std::cout << (ok ? "[OK]   " : "[FALHA] ") << name << " (" << sequential.size() << " valores)" << std::endl;
+    return ok;
+}
+
+// O bloco numérico termina no início da linha da próxima palavra-chave,
+// mesmo com brancos antes dela; sinais e pontos ainda são números
+bool checkBlockEnd() {
+    struct Case {
+        std::string numbers;
+        std::string rest;
+    };
+    std::vector<Case> cases = {
+        {"1 2 3\n4 5 6\n", "LINES 2 6\n"},
+        {"1 2 3\r\n-4 .5 +6\r\n", "  \tPOINT_DATA 2\r\n"},
+        {"\n\n1e3 2E-1\n\n", "SCALARS raio float\n"},
+        {"1 2 3\n4 5 6", ""},
+        {"", "CELL_DATA 1\n"},
+    };
+    bool ok = true;
+    for (const Case& test : cases) {
+        std::string text = test.numbers + test.rest;
+        const char* end = findNumericBlockEnd(text.data(), text.data() + text.size());
+        ok = ok && end == text.data() + test.numbers.size();
+    }
+    std::cout << (ok ? "[OK]   " : "[FALHA] ") << "fim_do_bloco" << std::endl;
+    return ok;
+}
+
+// Bloco com exatamente size bytes: a última linha é completada com espaços
+std::string blockOfSize(size_t size, unsigned seed) {
+    std::vector<float> values = randomValues(size / 12, seed);
+    std::string text = textBlock(values, 3, " ", "\n");
+    while (text.size() > size - 1) {
+        values.pop_back();
+        text = textBlock(values, 3, " ", "\n");
+    }
+    text.pop_back();
+    text.append(size - 1 - text.size(), ' ');
+    return text + "\n";
+}
+
+// Lê o bloco pelo readArraySource, que decide sozinho entre paralelo e sequencial
+bool checkThreshold(const char* name, size_t size) {
+    std::string text = blockOfSize(size, static_cast<unsigned>(size));
+    std::vector<float> sequential, parallel, loaded;
+    bool ok = text.size() == size && parseSequential(text, sequential) && parseParallel(text, 8, parallel) &&
+              parallel == sequential;
+    
+    ArraySource source;
+    source.encoding = ArraySource::Text;
+    source.type = ValueType::Float32;
+    source.end = text.size();
+    source.count = sequential.size();
+    loaded.resize(sequential.size());
+    ok = ok && readArraySource(text.data(), text.size(), source, loaded.data()) && loaded == sequential;
+    std::cout << (ok ? "[OK]   " : "[FALHA] ") << name << " (" << size << " bytes)" << std::endl;
+    return ok;
+}
+
+// Árvore binária com pointCount pontos, gravada em ASCII (com o título
+// completado até o arquivo ter fileSize bytes) ou em BINARY
+struct Tree {
+    std::vector<float> coords;      // x, y, z
+    std::vector<float> radii;
+};
+
+std::string treeBody(const Tree& tree, bool binary) {
+    size_t pointCount = tree.radii.size();
+    std::string out = "POINTS " + std::to_string(pointCount) + " float\n";
+    auto appendBigEndian = [&out](const void* value) {
+        const char* bytes = static_cast<const char*>(value);
+        for (int i = 3; i >= 0; i--) out += bytes[i];
+    };
+    
+    if (binary) for (float value : tree.coords) appendBigEndian(&value);
+    else out += textBlock(tree.coords, 3, " ", "\n");
+    
+    out += (binary ? "\n" : "") + std::string("LINES ") + std::to_string(pointCount - 1) + " " +
+           std::to_string((pointCount - 1) * 3) + "\n";
+    for (size_t i = 1; i < pointCount; i++) {
+        int32_t cell[3] = {2, static_cast<int32_t>((i - 1) / 2), static_cast<int32_t>(i)};
+        if (binary) for (int32_t value : cell) appendBigEndian(&value);
+        else out += "2 " + std::to_string(cell[1]) + " " + std::to_string(cell[2]) + "\n";
+    }
+    
+    out += (binary ? "\n" : "") + std::string("POINT_DATA ") + std::to_string(pointCount) +
+           "\nSCALARS raio float\nLOOKUP_TABLE default\n";
+    if (binary) for (float value : tree.radii) appendBigEndian(&value);
+    else out += textBlock(tree.radii, 9, " ", "\n");
+    return out;
+}
+
+std::string treeFile(const Tree& tree, bool binary, size_t fileSize) {
+    std::string header = std::string("# vtk DataFile Version 3.0\n");
+    std::string body = std::string(binary ? "BINARY" : "ASCII") + "\nDATASET POLYDATA\n" + treeBody(tree, binary);
+    std::string title = "limiar";
+    if (fileSize > header.size() + body.size() + title.size() + 1) {
+        title.append(fileSize - header.size() - body.size() - title.size() - 1, ' ');
+    }
+    return header + title + "\n" + body;
+}
+
+bool loadTree(const std::string& name, const std::string& contents, VTKLoader& loader) {
+    fs::path path = fs::temp_directory_path() / ("tp1_paralelo_" + name);
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << contents;
+    }
+    loader.setSidecarEnabled(false);
+    bool loaded = loader.loadFile(path.string());
+    fs::remove(path);
+    return loaded;
+}
+
+bool sameSegments(const VTKLoader& a, const VTKLoader& b) {
+    const auto& s = a.getSegments();
+    const auto& t = b.getSegments();
+    if (s.size() != t.size() || s.size() == 0) return false;
+    for (size_t i = 0; i < s.size(); i++) {
+        Segment x = s[i], y = t[i];
+        if (std::memcmp(&x, &y, sizeof(Segment)) != 0) return false;
+    }
+    return true;
+}
+
+// Arquivo ASCII com fileSize bytes contra a mesma árvore em BINARY, que
+// nunca é lido em paralelo
+bool checkFile(const char* name, const Tree& tree, size_t fileSize) {
+    std::string ascii = treeFile(tree, false, fileSize);
+    
+    std::ostringstream discarded;
+    std::streambuf* console = std::cout.rdbuf(discarded.rdbuf());
+    VTKLoader text, binary;
+    bool ok = ascii.size() == fileSize && loadTree("ascii.vtk", ascii, text) &&
+              loadTree("binary.vtk", treeFile(tree, true, 0), binary) && sameSegments(text, binary);
+    std::cout.rdbuf(console);
+    std::cout << (ok ? "[OK]   " : "[FALHA] ") << name << " (" << ascii.size() << " bytes)" << std::endl;
+    return ok;
+}
+
+}
+
+int main() {
+    int failures = 0;
+    
+    // Cortes no meio das linhas, com linhas de tamanhos variados
+    std::vector<float> values = randomValues(20011, 1);
+    failures += checkBlock("linhas_de_3", textBlock(values, 3, " ", "\n"), true) ? 0 : 1;
+    failures += checkBlock("linhas_de_7_crlf", textBlock(values, 7, "\t", "\r\n"), true) ? 0 : 1;
+    failures += checkBlock("linhas_longas", textBlock(values, 997, "  ", "\n"), true) ? 0 : 1;
+    failures += checkBlock("linha_unica", textBlock(values, values.size(), " ", ""), true) ? 0 : 1;
+    failures += checkBlock("linhas_em_branco", "\n\n  " + textBlock(values, 5, " ", "\n\n   "), true) ? 0 : 1;
+    
+    std::string broken = textBlock(values, 3, " ", "\n");
+    broken.replace(broken.size() / 2, 1, "x");
+    failures += checkBlock("texto_invalido", broken, false) ? 0 : 1;
+    failures += checkBlockEnd() ? 0 : 1;
+    
+    // Blocos dos dois lados do limite da leitura paralela
+    failures += checkThreshold("bloco_abaixo_do_limiar", parallelParseThreshold - 1) ? 0 : 1;
+    failures += checkThreshold("bloco_no_limiar", parallelParseThreshold) ? 0 : 1;
+    failures += checkThreshold("bloco_acima_do_limiar", parallelParseThreshold + 1) ? 0 : 1;
+    
+    // Arquivos inteiros: o parseVTK decide pelo tamanho do arquivo
+    Tree tree;
+    tree.coords = randomValues(150000 * 3, 2);
+    for (size_t i = 2; i < tree.coords.size(); i += 3) tree.coords[i] = 0;
+    tree.radii = randomValues(150000, 3);
+    for (auto& radius : tree.radii) radius = std::abs(radius) / 1000 + 0.01f;
+    if (treeFile(tree, false, 0).size() >= parallelParseThreshold) {
+        std::cout << "[FALHA] árvore de teste grande demais para o limiar" << std::endl;
+        failures++;
+    } else {
+        failures += checkFile("arquivo_abaixo_do_limiar", tree, parallelParseThreshold - 1) ? 0 : 1;
+        failures += checkFile("arquivo_no_limiar", tree, parallelParseThreshold) ? 0 : 1;
+    }
+    if (std::thread::hardware_concurrency() <= 1) {
+        std::cout << "    uma só thread neste processador: o carregador leu os arquivos em sequência" << std::endl;
+    }
+    
+    std::cout << (failures == 0 ? "Todos os testes passaram" : "Testes com falha: " + std::to_string(failures))
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+// Testes do cache binário (make test): um cache danificado em qualquer byte
+// precisa ser recusado ou dar a mesma árvore, nunca ler fora dos arrays.
+// Cada byte do .tp1cache é trocado por vez e o arquivo é carregado de novo.
+#include "VTKLoader.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* treeText =
+    "# vtk DataFile Version 3.0\n"
+    "cache\n"
+    "ASCII\n"
+    "DATASET POLYDATA\n"
+    "POINTS 8 float\n"
+    "0 0 0  0 1 0  -1 2 0  1 2 0  -1 3 0  -2 3 0  2 3 0  1 4 0\n"
+    "LINES 5 17\n"
+    "2 0 1\n"
+    "3 1 2 4\n"
+    "2 2 5\n"
+    "3 1 3 6\n"
+    "2 3 7\n"
+    "POINT_DATA 8\n"
+    "SCALARS raio float\n"
+    "LOOKUP_TABLE default\n"
+    "0.4 0.3 0.2 0.2 0.1 0.1 0.1 0.1\n";
+
+bool sameTree(const VTKLoader& a, const VTKLoader& b) {
+    const auto& s = a.getSegments();
+    const auto& t = b.getSegments();
+    if (s.size() != t.size() || s.size() == 0) return false;
+    for (size_t i = 0; i < s.size(); i++) {
+        Segment x = s[i], y = t[i];
+        if (std::memcmp(&x, &y, sizeof(Segment)) != 0) return false;
+    }
+    const TreeTopology& p = a.getTopology();
+    const TreeTopology& q = b.getTopology();
+    return p.parent == q.parent && p.childOffsets == q.childOffsets && p.childIndices == q.childIndices &&
+           p.roots == q.roots && p.depth == q.depth && p.descendantCount == q.descendantCount &&
+           p.preorder == q.preorder && p.chainOffsets == q.chainOffsets && p.maxDepth == q.maxDepth &&
+           p.maxDescendants == q.maxDescendants;
+}
+
+std::vector<char> readAll(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+void writeAll(const fs::path& path, const std::vector<char>& bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+}
+
+int main() {
+    fs::path directory = fs::temp_directory_path() / "tp1_sidecar_test";
+    fs::path cacheDirectory = directory / "cache";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    std::string source = (directory / "arvore.vtk").string();
+    {
+        std::ofstream file(source);
+        file << treeText;
+    }
+    
+    // As mensagens de carregamento de centenas de leituras ficam de fora
+    std::ostringstream discarded;
+    std::streambuf* console = std::cout.rdbuf(discarded.rdbuf());
+    
+    VTKLoader reference;
+    reference.setSidecarEnabled(false);
+    reference.loadFile(source);
+    
+    VTKLoader writer;
+    writer.setSidecarDirectory(cacheDirectory.string());
+    writer.loadFile(source);
+    
+    fs::path cachePath;
+    for (const auto& entry : fs::directory_iterator(cacheDirectory)) cachePath = entry.path();
+    std::vector<char> cache = cachePath.empty() ? std::vector<char>() : readAll(cachePath);
+    
+    int failures = 0;
+    size_t rejected = 0;
+    {
+        VTKLoader cached;
+        cached.setSidecarDirectory(cacheDirectory.string());
+        cached.loadFile(source);
+        if (cache.empty() || discarded.str().find("Cache binário carregado") == std::string::npos ||
+            !sameTree(reference, cached)) {
+            failures++;
+        }
+    }
+    
+    for (size_t i = 0; i < cache.size(); i++) {
+        std::vector<char> damaged = cache;
+        damaged[i] = static_cast<char>(damaged[i] ^ 0x5A);
+        writeAll(cachePath, damaged);
+        
+        discarded.str("");
+        VTKLoader loader;
+        loader.setSidecarDirectory(cacheDirectory.string());
+        loader.loadFile(source);
+        if (discarded.str().find("Cache binário carregado") == std::string::npos) rejected++;
+        if (!sameTree(reference, loader)) {
+            std::cout.rdbuf(console);
+            std::cout << "    byte " << i << " trocado: árvore diferente" << std::endl;
+            std::cout.rdbuf(discarded.rdbuf());
+            failures++;
+        }
+    }
+    
+    std::cout.rdbuf(console);
+    std::cout << (failures == 0 ? "[OK]   " : "[FALHA] ") << "cache danificado: " << cache.size()
+              << " bytes trocados, " << rejected << " caches recusados" << std::endl;
+    
+    // Um cache cortado no meio também é recusado
+    cache.resize(cache.size() / 2);
+    writeAll(cachePath, cache);
+    discarded.str("");
+    std::cout.rdbuf(discarded.rdbuf());
+    VTKLoader truncated;
+    truncated.setSidecarDirectory(cacheDirectory.string());
+    truncated.loadFile(source);
+    std::cout.rdbuf(console);
+    bool truncatedOk = discarded.str().find("Cache binário carregado") == std::string::npos &&
+                       sameTree(reference, truncated);
+    std::cout << (truncatedOk ? "[OK]   " : "[FALHA] ") << "cache cortado" << std::endl;
+    failures += truncatedOk ? 0 : 1;
+    
+    fs::remove_all(directory);
+    std::cout << (failures == 0 ? "Todos os testes passaram" : "Testes com falha: " + std::to_string(failures))
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
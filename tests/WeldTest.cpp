@@ -0,0 +1,107 @@
+// Testes de regressão da solda de pontas duplicadas do VTKLoader
+// (make test). Cada caso grava um VTK ASCII temporário, carrega sem cache
+// e confere o pai de cada segmento.
+#include "VTKLoader.h"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Case {
+    const char* name;
+    std::vector<std::pair<float, float>> points;
+    std::vector<std::vector<int>> lines;
+    std::vector<int> expectedParents;     // um por segmento, na ordem das linhas
+};
+
+std::string writeVTK(const Case& test) {
+    std::string path = (std::filesystem::temp_directory_path() / (std::string("tp1_") + test.name + ".vtk")).string();
+    std::ofstream out(path);
+    out.precision(9);       // o bastante para float voltar ao mesmo valor
+    out << "# vtk DataFile Version 3.0\n" << test.name << "\nASCII\nDATASET POLYDATA\n";
+    out << "POINTS " << test.points.size() << " float\n";
+    for (const auto& p : test.points) out << p.first << " " << p.second << " 0\n";
+    
+    size_t total = 0;
+    for (const auto& line : test.lines) total += line.size() + 1;
+    out << "LINES " << test.lines.size() << " " << total << "\n";
+    for (const auto& line : test.lines) {
+        out << line.size();
+        for (int id : line) out << " " << id;
+        out << "\n";
+    }
+    return path;
+}
+
+bool run(const Case& test) {
+    std::string path = writeVTK(test);
+    VTKLoader loader;
+    loader.setSidecarEnabled(false);
+    bool loaded = loader.loadFile(path);
+    std::filesystem::remove(path);
+    
+    const auto& segments = loader.getSegments();
+    bool ok = loaded && segments.size() == test.expectedParents.size();
+    for (size_t i = 0; ok && i < segments.size(); i++) {
+        Segment segment = segments[i];
+        if (segment.parentIndex != test.expectedParents[i]) {
+            std::cout << "    segmento " << i << ": pai " << segment.parentIndex
+                      << ", esperado " << test.expectedParents[i] << std::endl;
+            ok = false;
+        }
+    }
+    std::cout << (ok ? "[OK]   " : "[FALHA] ") << test.name << std::endl;
+    return ok;
+}
+
+}
+
+int main() {
+    // Raiz que se ramifica (0-1 e 0-2) e os pontos 4 e 5, próximos mas
+    // distintos: a conectividade já está completa e nada é soldado
+    Case branching{"raiz_ramificada",
+                   {{0, 0}, {0, 5}, {5, 0}, {8, 4}, {10, 10}, {10.001f, 10}, {12, 14}},
+                   {{0, 1}, {0, 2}, {2, 3}, {3, 5}, {1, 4}, {5, 6}},
+                   {-1, -1, 1, 2, 0, 3}};
+    
+    // A mesma árvore com os pontos repetidos em cada célula: cada início
+    // é soldado ao fim na mesma posição, e o ponto 10.001 continua separado
+    Case duplicated{"pontos_repetidos",
+                    {{0, 0}, {0, 5}, {0, 0}, {5, 0}, {5, 0}, {8, 4}, {8, 4}, {10.001f, 10},
+                     {0, 5}, {10, 10}, {10.001f, 10}, {12, 14}},
+                    {{0, 1}, {2, 3}, {4, 5}, {6, 7}, {8, 9}, {10, 11}},
+                    {-1, -1, 1, 2, 0, 3}};
+    
+    // Duas árvores separadas, com os pontos compartilhados
+    Case forest{"floresta",
+                {{0, 0}, {1, 1}, {2, 0}, {5, 5}, {6, 6}},
+                {{0, 1, 2}, {3, 4}},
+                {-1, 0, -1}};
+    
+    // Polyline fechada com pontos próprios: o fim coincide com o início, mas
+    // já estão ligados e a solda não pode fechar um ciclo
+    Case ring{"anel",
+              {{0, 0}, {1, 0}, {1, 1}, {0, 0}, {0, 0}, {-1, -1}},
+              {{0, 1, 2, 3}, {4, 5}},
+              {-1, 0, 1, 2}};
+    
+    // Pontos repetidos em que um deles difere só no último bit: a solda
+    // compara posições exatas, então esse início continua uma raiz e só o
+    // repetido exatamente é ligado
+    Case rounding{"arredondamento",
+                  {{0, 0}, {0, 5}, {0, std::nextafter(5.0f, 6.0f)}, {3, 8}, {3, 8}, {4, 9}},
+                  {{0, 1}, {2, 3}, {4, 5}},
+                  {-1, -1, 1}};
+    
+    int failures = 0;
+    for (const Case* test : {&branching, &duplicated, &forest, &ring, &rounding}) {
+        failures += run(*test) ? 0 : 1;
+    }
+    std::cout << (failures == 0 ? "Todos os testes passaram" : "Testes com falha: " + std::to_string(failures))
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}